@@ -0,0 +1,54 @@
+#!/usr/bin/env bash
+# Starts a headless server and N bot clients on this machine, then collects the server load report.
+#
+#   SERVER_BIN=Binaries/Linux/UdemyProjectServer CLIENT_BIN=Binaries/Linux/UdemyProject \
+#   Scripts/bot_load_test.sh [bots=8] [seconds=120]
+#
+# Bots connect straight to 127.0.0.1 through the IP net driver with the NULL online subsystem,
+# ready up in the lobby so ALobbyGameMode starts its countdown and travels to the game map, then run scripted input.
+# No GPU is needed: every process runs with -nullrhi -nosound.
+
+set -euo pipefail
+
+BOTS="${1:-8}"
+DURATION="${2:-120}"
+PROJECT_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+SERVER_BIN="${SERVER_BIN:-$PROJECT_DIR/Binaries/Linux/UdemyProjectServer}"
+CLIENT_BIN="${CLIENT_BIN:-$PROJECT_DIR/Binaries/Linux/UdemyProject}"
+PORT="${PORT:-7777}"
+LOG_DIR="$PROJECT_DIR/Saved/Logs"
+NULL_OSS="-ini:Engine:[OnlineSubsystem]:DefaultPlatformService=Null"
+
+PIDS=()
+cleanup() {
+	for PID in "${PIDS[@]}"; do
+		kill "$PID" 2>/dev/null || true
+	done
+	wait 2>/dev/null || true
+}
+trap cleanup EXIT
+
+rm -f "$LOG_DIR"/LoadTestServer.log
+
+"$SERVER_BIN" -port="$PORT" -LoadReport -ServerName=LoadTest "$NULL_OSS" -log=LoadTestServer.log -unattended &
+PIDS+=($!)
+
+# The lobby is loaded once the net driver listens
+DEADLINE=$((SECONDS + 60))
+until grep -q "listening on port" "$LOG_DIR"/LoadTestServer.log 2>/dev/null; do
+	if [ "$SECONDS" -ge "$DEADLINE" ]; then
+		echo "Server did not start, see $LOG_DIR/LoadTestServer.log"
+		exit 1
+	fi
+	sleep 1
+done
+
+for ((i = 0; i < BOTS; i++)); do
+	"$CLIENT_BIN" "127.0.0.1:$PORT" -game -nullrhi -nosound -BotClient -BotSeed="$i" "$NULL_OSS" -log="Bot$i.log" -unattended &
+	PIDS+=($!)
+done
+
+sleep "$DURATION"
+
+echo "Load reports:"
+ls -1 "$PROJECT_DIR"/Saved/Profiling/LoadReport-*.csv 2>/dev/null || echo "none found in $PROJECT_DIR/Saved/Profiling"
@@ -0,0 +1,31 @@
+#!/usr/bin/env bash
+# Runs bot_load_test.sh for growing bot counts and prints the per-client cost of the game map for each.
+# With the replication graph, frame time and bytes per client should stay roughly flat as the count grows.
+#
+#   Scripts/bot_scaling_test.sh [seconds per run=120] [bot counts...=8 16 32 64]
+
+set -euo pipefail
+
+DURATION="${1:-120}"
+shift || true
+COUNTS=("${@:-8 16 32 64}")
+COUNTS=(${COUNTS[@]})
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+PROFILING_DIR="$SCRIPT_DIR/../Saved/Profiling"
+
+printf "%6s %14s %14s %20s %12s\n" "Bots" "FrameMsAvg" "FrameMsMax" "OutBytesPerClient" "Corrections"
+
+for BOTS in "${COUNTS[@]}"; do
+	"$SCRIPT_DIR/bot_load_test.sh" "$BOTS" "$DURATION" > /dev/null
+
+	REPORT="$(ls -1t "$PROFILING_DIR"/LoadReport-ThirdPersonMap-*.csv 2>/dev/null | head -n 1)"
+	if [ -z "$REPORT" ]; then
+		printf "%6s %s\n" "$BOTS" "no game map report, did the lobby start the game?"
+		continue
+	fi
+
+	# Only rows with every bot connected
+	awk -F, -v Bots="$BOTS" 'NR > 1 && $2 == Bots { n++; frame += $3; if ($4 > max) max = $4; out += $6; corrections += $8 }
+		END { if (n == 0) { printf "%6s %s\n", Bots, "no rows with all bots connected"; exit }
+			printf "%6d %14.2f %14.2f %20.0f %12d\n", Bots, frame / n, max, out / n, corrections }' "$REPORT"
+done
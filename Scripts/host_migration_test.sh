@@ -0,0 +1,46 @@
+#!/usr/bin/env bash
+# Hosts a listen server game with bot clients, kills the host, then reports how long the
+# remaining players took to get back into a game through the host migration.
+#
+#   CLIENT_BIN=Binaries/Linux/UdemyProject Scripts/host_migration_test.sh [bots=2] [seconds before the host quits=30]
+#
+# Every process runs the NULL online subsystem on this machine, so the sessions are found over LAN.
+
+set -euo pipefail
+
+BOTS="${1:-2}"
+HOST_LIFETIME="${2:-30}"
+PROJECT_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+CLIENT_BIN="${CLIENT_BIN:-$PROJECT_DIR/Binaries/Linux/UdemyProject}"
+PORT="${PORT:-7777}"
+LOG_DIR="$PROJECT_DIR/Saved/Logs"
+NULL_OSS="-ini:Engine:[OnlineSubsystem]:DefaultPlatformService=Null"
+
+PIDS=()
+cleanup() {
+	for PID in "${PIDS[@]}"; do
+		kill "$PID" 2>/dev/null || true
+	done
+	wait 2>/dev/null || true
+}
+trap cleanup EXIT
+
+"$CLIENT_BIN" -game -nullrhi -nosound -port="$PORT" -ExecCmds="Host MigrationTest" "$NULL_OSS" -log=MigrationHost.log -unattended &
+HOST_PID=$!
+PIDS+=($HOST_PID)
+sleep 15
+
+for i in $(seq 0 $((BOTS - 1))); do
+	"$CLIENT_BIN" "127.0.0.1:$PORT" -game -nullrhi -nosound -BotClient -BotSeed="$i" "$NULL_OSS" -log="MigrationBot$i.log" -unattended &
+	PIDS+=($!)
+done
+
+sleep "$HOST_LIFETIME"
+
+echo "Killing the host"
+kill "$HOST_PID"
+
+# Election, one short search, hosting the map again and the others joining it
+sleep 25
+
+grep -h "takes over\|Host migration" "$LOG_DIR"/MigrationBot*.log || echo "No migration reported, see $LOG_DIR/MigrationBot*.log"
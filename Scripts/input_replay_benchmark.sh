@@ -0,0 +1,23 @@
+#!/usr/bin/env bash
+# Replays a recorded input file headlessly and prints the per-frame movement timings.
+#
+# Record a session first by playing with -RecordInput, files are written to Saved/InputRecordings:
+#   Binaries/Linux/UdemyProject /Game/ThirdPerson/Maps/ThirdPersonMap -game -RecordInput
+#
+# Then:
+#   CLIENT_BIN=Binaries/Linux/UdemyProject Scripts/input_replay_benchmark.sh <recording.uinput> [map=/Game/ThirdPerson/Maps/ThirdPersonMap]
+#
+# The replay runs as fast as the machine allows with the recorded frame times and quits when done.
+# Two runs of the same recording should log the same final location.
+
+set -euo pipefail
+
+RECORDING="$(realpath "$1")"
+MAP="${2:-/Game/ThirdPerson/Maps/ThirdPersonMap}"
+PROJECT_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+CLIENT_BIN="${CLIENT_BIN:-$PROJECT_DIR/Binaries/Linux/UdemyProject}"
+LOG_DIR="$PROJECT_DIR/Saved/Logs"
+
+"$CLIENT_BIN" "$MAP" -game -nullrhi -nosound -ReplayInput="$RECORDING" -log=InputReplay.log -unattended
+
+grep -h "Replayed\|Replay final location\|avg .* ms\|Replay timings" "$LOG_DIR"/InputReplay.log
@@ -0,0 +1,61 @@
+#!/usr/bin/env bash
+# Runs quick match on several game instances one after another and reports each one's click to lobby time.
+# The first finds nothing and falls back to hosting, the others should join it instead of hosting their own.
+# Fails when the median click to lobby time is not under MEDIAN_LIMIT_MS (2000 ms, the goal on LAN).
+#
+#   CLIENT_BIN=Binaries/Linux/UdemyProject Scripts/quick_match_test.sh [players=3] [seconds between players=10]
+#
+# Every process runs the NULL online subsystem on this machine, so the sessions are found over LAN.
+
+set -euo pipefail
+
+PLAYERS="${1:-3}"
+STAGGER="${2:-10}"
+PROJECT_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+CLIENT_BIN="${CLIENT_BIN:-$PROJECT_DIR/Binaries/Linux/UdemyProject}"
+LOG_DIR="$PROJECT_DIR/Saved/Logs"
+MEDIAN_LIMIT_MS="${MEDIAN_LIMIT_MS:-2000}"
+NULL_OSS="-ini:Engine:[OnlineSubsystem]:DefaultPlatformService=Null"
+
+PIDS=()
+cleanup() {
+	for PID in "${PIDS[@]}"; do
+		kill "$PID" 2>/dev/null || true
+	done
+	wait 2>/dev/null || true
+}
+trap cleanup EXIT
+
+rm -f "$LOG_DIR"/QuickMatch*.log
+
+for i in $(seq 0 $((PLAYERS - 1))); do
+	"$CLIENT_BIN" -game -nullrhi -nosound -ExecCmds="QuickMatch" "$NULL_OSS" -log="QuickMatch$i.log" -unattended &
+	PIDS+=($!)
+	sleep "$STAGGER"
+done
+
+# The last player's search, join and travel
+sleep 15
+
+for i in $(seq 0 $((PLAYERS - 1))); do
+	RESULT="$(grep -h "Quick match click to lobby\|Quick match failed\|Quick match found no session" "$LOG_DIR/QuickMatch$i.log" || true)"
+	echo "Player $i: ${RESULT:-no quick match result, see $LOG_DIR/QuickMatch$i.log}"
+done
+
+HOSTS="$(grep -l "Quick match found no session" "$LOG_DIR"/QuickMatch*.log | wc -l || true)"
+echo "$HOSTS of $PLAYERS players hosted"
+
+TIMES="$(sed -n 's/.*Quick match click to lobby: \([0-9]*\) ms.*/\1/p' "$LOG_DIR"/QuickMatch*.log | sort -n)"
+COUNT="$(echo "$TIMES" | grep -c . || true)"
+if [ "$COUNT" -eq 0 ]; then
+	echo "No player reached a lobby"
+	exit 1
+fi
+
+# Middle value, or the mean of the two middle values for an even count
+MEDIAN="$(echo "$TIMES" | awk '{ Values[NR] = $1 } END { if (NR % 2) print Values[(NR + 1) / 2]; else print int((Values[NR / 2] + Values[NR / 2 + 1]) / 2) }')"
+echo "Median click to lobby of $COUNT players: $MEDIAN ms (limit $MEDIAN_LIMIT_MS ms)"
+
+if [ "$MEDIAN" -ge "$MEDIAN_LIMIT_MS" ]; then
+	exit 1
+fi
@@ -0,0 +1,68 @@
+#!/usr/bin/env bash
+# Cuts the network of bot clients for a while once they are in the game map and reports how long each took
+# from the start of the outage until it was back in the game. The server holds each dropped pawn
+# for AUdemyProjectGameMode::ReconnectGraceSeconds.
+#
+#   SERVER_BIN=... CLIENT_BIN=... Scripts/reconnect_test.sh [drop after seconds in game=10] [outage seconds=10] [connection timeout=5]
+#
+# The outage drops every packet (net PktLoss 100) without closing anything, so client and server only notice it
+# through the connection timeout, which is set on both sides. An outage shorter than the timeout is survived.
+# Two bots are needed for the lobby to start the game. Needs a build with packet simulation, i.e. not shipping.
+
+set -euo pipefail
+
+DROP_AFTER="${1:-10}"
+OUTAGE="${2:-10}"
+TIMEOUT="${3:-5}"
+PROJECT_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+SERVER_BIN="${SERVER_BIN:-$PROJECT_DIR/Binaries/Linux/UdemyProjectServer}"
+CLIENT_BIN="${CLIENT_BIN:-$PROJECT_DIR/Binaries/Linux/UdemyProject}"
+PORT="${PORT:-7777}"
+LOG_DIR="$PROJECT_DIR/Saved/Logs"
+NULL_OSS="-ini:Engine:[OnlineSubsystem]:DefaultPlatformService=Null"
+NET_TIMEOUT="-ini:Engine:[/Script/OnlineSubsystemUtils.IpNetDriver]:ConnectionTimeout=$TIMEOUT"
+
+PIDS=()
+cleanup() {
+	for PID in "${PIDS[@]}"; do
+		kill "$PID" 2>/dev/null || true
+	done
+	wait 2>/dev/null || true
+}
+trap cleanup EXIT
+
+# Waits until <count> of the log files contain the pattern, or gives up after <seconds>
+wait_for_logs() {
+	local PATTERN="$1" COUNT="$2" DEADLINE=$((SECONDS + $3))
+	shift 3
+	until [ "$(grep -l "$PATTERN" "$@" 2>/dev/null | wc -l)" -ge "$COUNT" ]; do
+		if [ "$SECONDS" -ge "$DEADLINE" ]; then
+			return 1
+		fi
+		sleep 1
+	done
+}
+
+rm -f "$LOG_DIR"/ReconnectServer.log "$LOG_DIR"/ReconnectBot*.log
+
+"$SERVER_BIN" -port="$PORT" -ServerName=ReconnectTest "$NULL_OSS" "$NET_TIMEOUT" -log=ReconnectServer.log -unattended &
+PIDS+=($!)
+
+wait_for_logs "listening on port" 1 60 "$LOG_DIR"/ReconnectServer.log || { echo "Server did not start, see $LOG_DIR/ReconnectServer.log"; exit 1; }
+
+for i in 0 1; do
+	"$CLIENT_BIN" "127.0.0.1:$PORT" -game -nullrhi -nosound -BotClient -BotSeed="$i" -BotDropConnectionAfter="$DROP_AFTER" -BotOutageSeconds="$OUTAGE" "$NULL_OSS" "$NET_TIMEOUT" -log="ReconnectBot$i.log" -unattended &
+	PIDS+=($!)
+done
+
+wait_for_logs "Simulating a" 2 120 "$LOG_DIR"/ReconnectBot*.log || { echo "Bots did not reach the game map, see $LOG_DIR/ReconnectBot*.log"; exit 1; }
+
+# The outage, the timeout, then the backoff of the reconnect itself
+RESULTS="Back in game\|Connection survived\|Could not reconnect"
+wait_for_logs "$RESULTS" 2 $((OUTAGE + TIMEOUT + 60)) "$LOG_DIR"/ReconnectBot*.log || true
+
+for i in 0 1; do
+	RESULT="$(grep -h "$RESULTS" "$LOG_DIR/ReconnectBot$i.log" || true)"
+	echo "Bot $i: ${RESULT:-no result, see $LOG_DIR/ReconnectBot$i.log}"
+done
+grep -h "reclaimed their pawn" "$LOG_DIR"/ReconnectServer.log || true
@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AssetPreloadSubsystem.h"
+
+#include "Engine/AssetManager.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+	FAutoConsoleCommandWithWorld AssetLoadTimingsCommand(
+		TEXT("udemy.AssetLoadTimings"),
+		TEXT("Lists the assets loaded through UAssetPreloadSubsystem and how long each load took."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			const UAssetPreloadSubsystem* AssetPreload = UAssetPreloadSubsystem::Get(World);
+			if (AssetPreload != nullptr)
+				AssetPreload->PrintTimings();
+		}));
+}
+
+UAssetPreloadSubsystem* UAssetPreloadSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject != nullptr ? WorldContextObject->GetWorld() : nullptr;
+	const UGameInstance* GameInstance = World != nullptr ? World->GetGameInstance() : nullptr;
+	return GameInstance != nullptr ? GameInstance->GetSubsystem<UAssetPreloadSubsystem>() : nullptr;
+}
+
+void UAssetPreloadSubsystem::Deinitialize()
+{
+	for (const TSharedPtr<FStreamableHandle>& Handle : PreloadHandles)
+	{
+		if (Handle.IsValid())
+			Handle->CancelHandle();
+	}
+	PreloadHandles.Reset();
+
+	Super::Deinitialize();
+}
+
+void UAssetPreloadSubsystem::Preload(const FString& Label, const TArray<FSoftObjectPath>& Assets)
+{
+	if (Assets.Num() == 0)
+		return;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Assets,
+		FStreamableDelegate::CreateWeakLambda(this, [this, Label, StartTime]()
+		{
+			AddTiming(Label, StartTime, true);
+		}));
+
+	if (Handle.IsValid())
+		PreloadHandles.Add(Handle);
+}
+
+UObject* UAssetPreloadSubsystem::LoadNow(const FSoftObjectPath& Asset)
+{
+	if (Asset.IsNull())
+		return nullptr;
+
+	if (UObject* Loaded = Asset.ResolveObject())
+		return Loaded;
+
+	// A synchronous load here means the asset was needed before its preload finished, or was never preloaded
+	const double StartTime = FPlatformTime::Seconds();
+
+	UObject* Loaded = UAssetManager::GetStreamableManager().LoadSynchronous(Asset);
+	if (Loaded != nullptr)
+		LoadedAssets.Add(Loaded);
+
+	AddTiming(Asset.ToString(), StartTime, false);
+
+	return Loaded;
+}
+
+void UAssetPreloadSubsystem::AddTiming(const FString& Label, double StartTime, bool bAsync)
+{
+	FLoadTiming& Timing = Timings.AddDefaulted_GetRef();
+	Timing.Label = Label;
+	Timing.Milliseconds = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	Timing.bAsync = bAsync;
+
+	UE_LOG(LogTemp, Log, TEXT("Loaded %s %s in %.1f ms"), *Timing.Label, bAsync ? TEXT("in the background") : TEXT("on demand"), Timing.Milliseconds);
+}
+
+void UAssetPreloadSubsystem::PrintTimings() const
+{
+	for (const FLoadTiming& Timing : Timings)
+	{
+		UE_LOG(LogTemp, Display, TEXT("  %8.1f ms %s %s"), Timing.Milliseconds, Timing.bAsync ? TEXT("async") : TEXT("sync "), *Timing.Label);
+	}
+}
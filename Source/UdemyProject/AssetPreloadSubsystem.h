@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "AssetPreloadSubsystem.generated.h"
+
+/**
+ * Loads assets referenced softly by the project's classes, so constructing a class default object never loads content.
+ * Preload() streams a group in the background and keeps it in memory for the lifetime of the game instance,
+ * LoadNow() loads on demand. Both are timed and logged, "udemy.AssetLoadTimings" lists them.
+ */
+UCLASS()
+class UDEMYPROJECT_API UAssetPreloadSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UAssetPreloadSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Deinitialize() override;
+
+	void Preload(const FString& Label, const TArray<FSoftObjectPath>& Assets);
+
+	/** Returns the asset, loading it synchronously if it was not preloaded yet */
+	UObject* LoadNow(const FSoftObjectPath& Asset);
+
+	template<typename T>
+	T* LoadNow(const TSoftObjectPtr<T>& Asset)
+	{
+		return Cast<T>(LoadNow(Asset.ToSoftObjectPath()));
+	}
+
+	template<typename T>
+	TSubclassOf<T> LoadNow(const TSoftClassPtr<T>& Class)
+	{
+		return Cast<UClass>(LoadNow(Class.ToSoftObjectPath()));
+	}
+
+	/** Loads through the subsystem of the context's game instance, or directly when there is none, e.g. in editor previews */
+	template<typename T>
+	static T* Load(const UObject* WorldContextObject, const TSoftObjectPtr<T>& Asset)
+	{
+		UAssetPreloadSubsystem* AssetPreload = Get(WorldContextObject);
+		return AssetPreload != nullptr ? AssetPreload->LoadNow(Asset) : Asset.LoadSynchronous();
+	}
+
+	template<typename T>
+	static TSubclassOf<T> Load(const UObject* WorldContextObject, const TSoftClassPtr<T>& Class)
+	{
+		UAssetPreloadSubsystem* AssetPreload = Get(WorldContextObject);
+		return AssetPreload != nullptr ? AssetPreload->LoadNow(Class) : Class.LoadSynchronous();
+	}
+
+	void PrintTimings() const;
+
+private:
+	struct FLoadTiming
+	{
+		FString Label;
+		double Milliseconds = 0.0;
+		bool bAsync = false;
+	};
+
+	void AddTiming(const FString& Label, double StartTime, bool bAsync);
+
+	TArray<TSharedPtr<FStreamableHandle>> PreloadHandles;
+
+	// Keeps assets loaded on demand alive like the preloaded ones
+	UPROPERTY()
+	TArray<UObject*> LoadedAssets;
+
+	TArray<FLoadTiming> Timings;
+};
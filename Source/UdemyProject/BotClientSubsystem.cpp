@@ -0,0 +1,133 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BotClientSubsystem.h"
+
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+
+#include "InputRecordingSubsystem.h"
+#include "LobbyGameState.h"
+#include "LobbyPlayerController.h"
+#include "LobbyPlayerState.h"
+#include "UdemyPlatformGameInstance.h"
+#include "UdemyProjectCharacter.h"
+
+bool UBotClientSubsystem::bConnectionDropped = false;
+
+bool UBotClientSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("BotClient")) && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UBotClientSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Bots started together still walk different paths
+	int32 Seed = FPlatformProcess::GetCurrentProcessId();
+	FParse::Value(FCommandLine::Get(), TEXT("BotSeed="), Seed);
+	Random.Initialize(Seed);
+
+	FParse::Value(FCommandLine::Get(), TEXT("BotDropConnectionAfter="), DropConnectionAfter);
+	FParse::Value(FCommandLine::Get(), TEXT("BotOutageSeconds="), OutageSeconds);
+	FParse::Value(FCommandLine::Get(), TEXT("BotReadyAfter="), ReadyDelay);
+}
+
+void UBotClientSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	UWorld* World = GetWorld();
+	if (World == nullptr || World->GetNetMode() != NM_Client)
+		return;
+
+	APlayerController* PlayerController = World->GetFirstPlayerController();
+	if (PlayerController == nullptr)
+		return;
+
+	// Readies up once the lobby has replicated this player, so the ready check can start the game early
+	if (ALobbyPlayerController* LobbyController = Cast<ALobbyPlayerController>(PlayerController))
+	{
+		const ALobbyPlayerState* LobbyPlayerState = LobbyController->GetPlayerState<ALobbyPlayerState>();
+		if (!bReadySent && LobbyPlayerState != nullptr && !LobbyPlayerState->IsReady() && World->GetTimeSeconds() >= ReadyDelay)
+		{
+			bReadySent = true;
+			LobbyController->ToggleReady();
+		}
+	}
+
+	AUdemyProjectCharacter* Character = Cast<AUdemyProjectCharacter>(PlayerController->GetPawn());
+	if (Character == nullptr)
+		return;
+
+	// Counted per world, so the drop happens that long after arriving in the game map rather than in the lobby
+	const bool bInGame = World->GetGameState() != nullptr && !World->GetGameState()->IsA<ALobbyGameState>();
+	if (DropConnectionAfter > 0.0f && !bConnectionDropped && bInGame && World->GetTimeSeconds() >= DropConnectionAfter)
+	{
+		bConnectionDropped = true;
+
+		UUdemyPlatformGameInstance* GameInstance = Cast<UUdemyPlatformGameInstance>(World->GetGameInstance());
+		if (GameInstance != nullptr)
+			GameInstance->SimulateConnectionDrop(OutageSeconds);
+		return;
+	}
+
+	// A new pawn, e.g. after a reconnect or the travel to the game map, starts with nothing held
+	if (InputCharacter != Character)
+	{
+		InputCharacter = Character;
+		bSprintHeld = false;
+		bJumpHeld = false;
+	}
+
+	FRecordedInputFrame Input;
+
+	// Held for one frame, so the movement component sees the press before the release
+	if (bJumpHeld)
+	{
+		Input.Buttons |= FRecordedInputFrame::JumpStopped;
+		bJumpHeld = false;
+	}
+
+	StepTimeLeft -= DeltaTime;
+	if (StepTimeLeft <= 0.0f)
+	{
+		StepTimeLeft = StepInterval;
+		NextScriptStep(Input);
+	}
+
+	// Movement input is consumed every frame, like a held key
+	Input.Move = FVector2f(MoveInput);
+
+	Character->ReplayInput(Input);
+}
+
+TStatId UBotClientSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBotClientSubsystem, STATGROUP_Tickables);
+}
+
+void UBotClientSubsystem::NextScriptStep(FRecordedInputFrame& Input)
+{
+	// Relative to the camera, like a stick or WASD
+	const float Angle = Random.FRandRange(0.0f, 2.0f * PI);
+	MoveInput = FVector2D(FMath::Cos(Angle), FMath::Sin(Angle));
+
+	const bool bSprint = Random.FRand() < 0.5f;
+	if (bSprint != bSprintHeld)
+	{
+		Input.Buttons |= bSprint ? FRecordedInputFrame::DashStarted : FRecordedInputFrame::DashStopped;
+		bSprintHeld = bSprint;
+	}
+
+	if (Random.FRand() < 0.25f)
+		Input.Buttons |= FRecordedInputFrame::Dodge;
+
+	if (Random.FRand() < 0.3f)
+	{
+		Input.Buttons |= FRecordedInputFrame::JumpStarted;
+		bJumpHeld = true;
+	}
+}
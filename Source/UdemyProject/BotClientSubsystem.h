@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BotClientSubsystem.generated.h"
+
+/**
+ * Drives the local character with scripted input when the game runs with -BotClient,
+ * so a server can be loaded with many headless clients instead of players clicking through the menu.
+ * In the lobby the bot readies up, then every few seconds it picks a new direction and may sprint, jump or dodge.
+ * The input goes through the character's input handlers, so bots send the same RPCs as players.
+ */
+UCLASS()
+class UDEMYPROJECT_API UBotClientSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	void NextScriptStep(struct FRecordedInputFrame& Input);
+
+	// Seconds between two script steps
+	float StepInterval = 2.0f;
+	float StepTimeLeft = 0.0f;
+
+	// Move action value, held until the next step
+	FVector2D MoveInput = FVector2D(0.0f, 1.0f);
+
+	// Buttons held down on the character, released again by a later frame
+	TWeakObjectPtr<class AUdemyProjectCharacter> InputCharacter;
+	bool bSprintHeld = false;
+	bool bJumpHeld = false;
+
+	FRandomStream Random;
+
+	// -BotReadyAfter=<seconds> in the lobby before readying up, once per lobby world
+	float ReadyDelay = 2.0f;
+	bool bReadySent = false;
+
+	// -BotDropConnectionAfter=<seconds> cuts the network once for -BotOutageSeconds=<seconds>, to measure the reconnect
+	float DropConnectionAfter = 0.0f;
+	float OutageSeconds = 10.0f;
+	static bool bConnectionDropped;
+};
@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HostMigrationSubsystem.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerState.h"
+#include "TimerManager.h"
+
+#include "LobbyPlayerState.h"
+#include "MovingPlatform.h"
+#include "UdemyPlatformGameInstance.h"
+#include "UdemyProjectGameMode.h"
+#include "UdemyProjectGameState.h"
+
+void UHostMigrationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UHostMigrationSubsystem::OnPostLoadMap);
+}
+
+void UHostMigrationSubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+
+	Super::Deinitialize();
+}
+
+void UHostMigrationSubsystem::OnPostLoadMap(UWorld* World)
+{
+	// The timer lives on the game instance's timer manager and outlasts the world that started it
+	GetGameInstance()->GetTimerManager().ClearTimer(CaptureTimer);
+
+	// A snapshot only describes the world of the host that sent it
+	Snapshot.Reset();
+
+	// Dedicated servers do not leave with a player, their clients reconnect instead
+	if (World != nullptr && World->GetNetMode() == NM_ListenServer)
+		World->GetTimerManager().SetTimer(CaptureTimer, this, &UHostMigrationSubsystem::CaptureSnapshot, SnapshotInterval, true);
+}
+
+void UHostMigrationSubsystem::ReceiveSnapshot(const FHostMigrationSnapshot& NewSnapshot)
+{
+	// Dedicated servers never fill it in
+	if (NewSnapshot.HostKey.IsEmpty())
+		return;
+
+	Snapshot = NewSnapshot;
+}
+
+void UHostMigrationSubsystem::CaptureSnapshot()
+{
+	// Only the host captures, a client's snapshot would name itself as the host
+	UWorld* World = GetGameInstance()->GetWorld();
+	if (World == nullptr || World->GetNetMode() != NM_ListenServer)
+		return;
+
+	AUdemyProjectGameState* GameState = World->GetGameState<AUdemyProjectGameState>();
+	if (GameState == nullptr)
+		return;
+
+	const UUdemyPlatformGameInstance* GameInstance = Cast<UUdemyPlatformGameInstance>(GetGameInstance());
+
+	FHostMigrationSnapshot& NewSnapshot = Snapshot.Emplace();
+	NewSnapshot.HostKey = GetLocalPlayerKey();
+	NewSnapshot.ServerName = GameInstance != nullptr ? GameInstance->GetServerName() : FString();
+	NewSnapshot.MapName = UWorld::RemovePIEPrefix(World->GetOutermost()->GetName());
+
+	for (APlayerState* PlayerState : GameState->PlayerArray)
+	{
+		if (PlayerState == nullptr)
+			continue;
+
+		FPlayerSnapshot& Player = NewSnapshot.Players.AddDefaulted_GetRef();
+		Player.PlayerKey = AUdemyProjectGameMode::GetPlayerKey(PlayerState->GetUniqueId());
+
+		if (const APawn* Pawn = PlayerState->GetPawn())
+		{
+			Player.Location = Pawn->GetActorLocation();
+			Player.Yaw = Pawn->GetActorRotation().Yaw;
+		}
+
+		const ALobbyPlayerState* LobbyPlayerState = Cast<ALobbyPlayerState>(PlayerState);
+		Player.bReady = LobbyPlayerState != nullptr && LobbyPlayerState->IsReady();
+	}
+
+	for (TActorIterator<AMovingPlatform> It(World); It; ++It)
+	{
+		FPlatformSnapshot& Platform = NewSnapshot.Platforms.AddDefaulted_GetRef();
+		Platform.PlatformName = It->GetFName();
+		Platform.PhaseDistance = It->GetPhaseDistance();
+	}
+
+	GameState->SetMigrationSnapshot(NewSnapshot);
+}
+
+FString UHostMigrationSubsystem::ElectHost() const
+{
+	if (!Snapshot.IsSet())
+		return FString();
+
+	FString Elected;
+	for (const FPlayerSnapshot& Player : Snapshot->Players)
+	{
+		if (Player.PlayerKey.IsEmpty() || Player.PlayerKey == Snapshot->HostKey)
+			continue;
+
+		if (Elected.IsEmpty() || Player.PlayerKey < Elected)
+			Elected = Player.PlayerKey;
+	}
+
+	return Elected;
+}
+
+FString UHostMigrationSubsystem::GetLocalPlayerKey() const
+{
+	const ULocalPlayer* LocalPlayer = GetGameInstance()->GetFirstGamePlayer();
+	if (LocalPlayer == nullptr)
+		return FString();
+
+	return AUdemyProjectGameMode::GetPlayerKey(LocalPlayer->GetPreferredUniqueNetId());
+}
+
+void UHostMigrationSubsystem::BeginRestore(const FHostMigrationSnapshot& RestoreSnapshot)
+{
+	Restore = RestoreSnapshot;
+	RestoreDeadline = FPlatformTime::Seconds() + RestoreTimeout;
+}
+
+void UHostMigrationSubsystem::RestorePlatforms(UWorld* World)
+{
+	if (!Restore.IsSet() || World == nullptr || FPlatformTime::Seconds() > RestoreDeadline)
+		return;
+
+	if (UWorld::RemovePIEPrefix(World->GetOutermost()->GetName()) != Restore->MapName)
+		return;
+
+	for (TActorIterator<AMovingPlatform> It(World); It; ++It)
+	{
+		const FPlatformSnapshot* Platform = Restore->Platforms.FindByPredicate([&It](const FPlatformSnapshot& Other) { return Other.PlatformName == It->GetFName(); });
+		if (Platform != nullptr)
+			It->SetPhaseDistance(Platform->PhaseDistance);
+	}
+
+	Restore->Platforms.Reset();
+}
+
+bool UHostMigrationSubsystem::TakeRestoredPlayer(const FString& PlayerKey, FPlayerSnapshot& OutPlayer)
+{
+	if (!Restore.IsSet() || PlayerKey.IsEmpty())
+		return false;
+
+	if (FPlatformTime::Seconds() > RestoreDeadline)
+	{
+		Restore.Reset();
+		return false;
+	}
+
+	const int32 Index = Restore->Players.IndexOfByPredicate([&PlayerKey](const FPlayerSnapshot& Other) { return Other.PlayerKey == PlayerKey; });
+	if (Index == INDEX_NONE)
+		return false;
+
+	OutPlayer = Restore->Players[Index];
+	Restore->Players.RemoveAtSwap(Index);
+	return true;
+}
@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "HostMigrationSubsystem.generated.h"
+
+USTRUCT()
+struct FPlayerSnapshot
+{
+	GENERATED_BODY()
+
+	// Unique net id as a string, see AUdemyProjectGameMode::GetPlayerKey
+	UPROPERTY()
+	FString PlayerKey;
+
+	UPROPERTY()
+	FVector_NetQuantize Location;
+
+	UPROPERTY()
+	float Yaw = 0.0f;
+
+	// Lobby ready flag
+	UPROPERTY()
+	bool bReady = false;
+};
+
+USTRUCT()
+struct FPlatformSnapshot
+{
+	GENERATED_BODY()
+
+	// Platforms are placed in the level, so their names match on every machine
+	UPROPERTY()
+	FName PlatformName;
+
+	UPROPERTY()
+	float PhaseDistance = 0.0f;
+};
+
+/** What a new host needs to carry on where the old one stopped */
+USTRUCT()
+struct FHostMigrationSnapshot
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString HostKey;
+
+	UPROPERTY()
+	FString ServerName;
+
+	// Package name of the map being played
+	UPROPERTY()
+	FString MapName;
+
+	UPROPERTY()
+	TArray<FPlayerSnapshot> Players;
+
+	UPROPERTY()
+	TArray<FPlatformSnapshot> Platforms;
+};
+
+/**
+ * Host side, snapshots players, platforms and lobby state of a listen server every SnapshotInterval
+ * and replicates it through AUdemyProjectGameState. Client side, keeps the last snapshot received.
+ * When the host is lost the game instance elects the new host from it, and the new host's game mode
+ * restores the players and platforms as they were.
+ */
+UCLASS()
+class UDEMYPROJECT_API UHostMigrationSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	void ReceiveSnapshot(const FHostMigrationSnapshot& Snapshot);
+
+	/** Last snapshot of the current world's host, if it is a listen server */
+	const TOptional<FHostMigrationSnapshot>& GetSnapshot() const { return Snapshot; }
+
+	/** Every remaining player picks the same one: the lowest key that is not the old host's */
+	FString ElectHost() const;
+
+	FString GetLocalPlayerKey() const;
+
+	/** Called on the elected host, the restore is handed out to the next map for RestoreTimeout seconds */
+	void BeginRestore(const FHostMigrationSnapshot& RestoreSnapshot);
+
+	/** Moves the platforms of the world to their snapshot phases */
+	void RestorePlatforms(UWorld* World);
+
+	/** Location and lobby state of a returning player, each player is restored once */
+	bool TakeRestoredPlayer(const FString& PlayerKey, FPlayerSnapshot& OutPlayer);
+
+private:
+	void OnPostLoadMap(UWorld* World);
+
+	void CaptureSnapshot();
+
+	TOptional<FHostMigrationSnapshot> Snapshot;
+
+	TOptional<FHostMigrationSnapshot> Restore;
+	double RestoreDeadline = 0.0;
+
+	// Seconds between two snapshots of the host
+	float SnapshotInterval = 1.0f;
+
+	// Players who have not rejoined the new host by then spawn as new players
+	float RestoreTimeout = 30.0f;
+
+	FTimerHandle CaptureTimer;
+	FDelegateHandle PostLoadMapHandle;
+};
@@ -0,0 +1,268 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InputRecordingSubsystem.h"
+
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+#include "TickProfilerSubsystem.h"
+#include "UdemyProjectCharacter.h"
+
+namespace
+{
+	constexpr uint32 RecordingMagic = 0x504E4955; // "UINP"
+	constexpr uint32 RecordingVersion = 1;
+}
+
+bool UInputRecordingSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	FString ReplayPath;
+	const bool bWanted = FParse::Param(FCommandLine::Get(), TEXT("RecordInput")) || FParse::Value(FCommandLine::Get(), TEXT("ReplayInput="), ReplayPath);
+
+	return bWanted && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UInputRecordingSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (InWorld.GetNetMode() == NM_DedicatedServer)
+		return;
+
+	MapName = UWorld::RemovePIEPrefix(InWorld.GetOutermost()->GetName());
+
+	FString ReplayPath;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("ReplayInput="), ReplayPath))
+	{
+		bRecording = true;
+		return;
+	}
+
+	// Only the map the input was recorded on replays it, e.g. not the menu loaded first
+	if (!LoadRecording(ReplayPath))
+		return;
+
+	bReplaying = true;
+	ReplayStartTime = FPlatformTime::Seconds();
+
+	// Every frame gets the recorded frame time, and no frame waits for the frame rate limit
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(Frames[0].DeltaTime);
+
+	WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UInputRecordingSubsystem::OnWorldTickStart);
+
+	UE_LOG(LogTemp, Log, TEXT("Replaying %d frames of input on %s"), Frames.Num(), *MapName);
+}
+
+void UInputRecordingSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+
+	if (bRecording && Frames.Num() > 0)
+		SaveRecording();
+
+	if (bReplaying)
+		FApp::SetUseFixedTimeStep(false);
+
+	Super::Deinitialize();
+}
+
+void UInputRecordingSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (bRecording)
+	{
+		// Frames before the character is possessed have no input to give
+		if (GetLocalCharacter() == nullptr)
+			return;
+
+		CurrentFrame.DeltaTime = FApp::GetDeltaTime();
+		Frames.Add(CurrentFrame);
+		CurrentFrame = FRecordedInputFrame();
+		return;
+	}
+
+	if (!bReplaying || !bFrameReplayed)
+		return;
+
+	bFrameReplayed = false;
+
+	// The profiler starts its frame at the world tick start too, so its current frame is the replayed one
+	const UTickProfilerSubsystem* Profiler = GetWorld()->GetSubsystem<UTickProfilerSubsystem>();
+
+	TArray<float>& Row = ReplayTimings.AddDefaulted_GetRef();
+	Row.Add((FPlatformTime::Seconds() - FrameStartTime) * 1000.0);
+	for (int32 i = 0; i < (int32)ETickProfilerCategory::Num; ++i)
+		Row.Add(Profiler != nullptr ? Profiler->GetCurrentFrameTime((ETickProfilerCategory)i) * 1000.0 : 0.0);
+
+	if (ReplayIndex >= Frames.Num())
+		FinishReplay();
+}
+
+TStatId UInputRecordingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInputRecordingSubsystem, STATGROUP_Tickables);
+}
+
+void UInputRecordingSubsystem::RecordMove(const FVector2D& Value)
+{
+	if (bRecording)
+		CurrentFrame.Move = FVector2f(Value);
+}
+
+void UInputRecordingSubsystem::RecordLook(const FVector2D& Value)
+{
+	// Several mouse events can arrive in one frame
+	if (bRecording)
+		CurrentFrame.Look += FVector2f(Value);
+}
+
+void UInputRecordingSubsystem::RecordButton(FRecordedInputFrame::EButton Button)
+{
+	if (bRecording)
+		CurrentFrame.Buttons |= Button;
+}
+
+void UInputRecordingSubsystem::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld() || !bReplaying || ReplayIndex >= Frames.Num())
+		return;
+
+	AUdemyProjectCharacter* Character = GetLocalCharacter();
+	if (Character == nullptr)
+		return;
+
+	FrameStartTime = FPlatformTime::Seconds();
+	bFrameReplayed = true;
+
+	// Consumed by this frame's movement update, like input processed by the player controller
+	Character->ReplayInput(Frames[ReplayIndex]);
+	++ReplayIndex;
+
+	if (ReplayIndex < Frames.Num())
+		FApp::SetFixedDeltaTime(Frames[ReplayIndex].DeltaTime);
+}
+
+void UInputRecordingSubsystem::FinishReplay()
+{
+	bReplaying = false;
+	FApp::SetUseFixedTimeStep(false);
+
+	double RecordedSeconds = 0.0;
+	for (const FRecordedInputFrame& Frame : Frames)
+		RecordedSeconds += Frame.DeltaTime;
+
+	UE_LOG(LogTemp, Log, TEXT("Replayed %.1f s of input in %.1f s"), RecordedSeconds, FPlatformTime::Seconds() - ReplayStartTime);
+
+	// Two runs of the same recording end on the same spot if movement is deterministic
+	if (const AUdemyProjectCharacter* Character = GetLocalCharacter())
+		UE_LOG(LogTemp, Log, TEXT("Replay final location %s"), *Character->GetActorLocation().ToString());
+
+	FString Csv = TEXT("Frame,FrameMs");
+	for (int32 i = 0; i < (int32)ETickProfilerCategory::Num; ++i)
+		Csv += FString::Printf(TEXT(",%sMs"), GetTickProfilerCategoryName((ETickProfilerCategory)i));
+	Csv += TEXT("\n");
+
+	for (int32 i = 0; i < ReplayTimings.Num(); ++i)
+	{
+		Csv += FString::FromInt(i);
+		for (float Value : ReplayTimings[i])
+			Csv += FString::Printf(TEXT(",%.3f"), Value);
+		Csv += TEXT("\n");
+	}
+
+	const FString ReportPath = FPaths::ProfilingDir() / FString::Printf(TEXT("InputReplay-%s-%s.csv"), *FPackageName::GetShortName(MapName), *FDateTime::Now().ToString());
+	FFileHelper::SaveStringToFile(Csv, *ReportPath);
+
+	const int32 NumColumns = (int32)ETickProfilerCategory::Num + 1;
+	for (int32 Column = 0; Column < NumColumns && ReplayTimings.Num() > 0; ++Column)
+	{
+		TArray<float> Values;
+		Values.Reserve(ReplayTimings.Num());
+		for (const TArray<float>& Row : ReplayTimings)
+			Values.Add(Row[Column]);
+
+		Values.Sort();
+
+		double Sum = 0.0;
+		for (float Value : Values)
+			Sum += Value;
+
+		UE_LOG(LogTemp, Log, TEXT("  %s: avg %.3f ms, p95 %.3f ms, max %.3f ms"),
+			Column == 0 ? TEXT("Frame") : GetTickProfilerCategoryName((ETickProfilerCategory)(Column - 1)),
+			Sum / Values.Num(),
+			Values[FMath::Min(FMath::FloorToInt(Values.Num() * 0.95f), Values.Num() - 1)],
+			Values.Last());
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Replay timings written to %s"), *ReportPath);
+
+	FPlatformMisc::RequestExit(false);
+}
+
+bool UInputRecordingSubsystem::LoadRecording(const FString& Path)
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *Path))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Could not read input recording %s"), *Path);
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	FString RecordedMapName;
+	Reader << Magic << Version;
+
+	if (Magic != RecordingMagic || Version != RecordingVersion)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s is not an input recording of this version"), *Path);
+		return false;
+	}
+
+	Reader << RecordedMapName;
+	if (RecordedMapName != MapName)
+		return false;
+
+	Reader << Frames;
+
+	return !Reader.IsError() && Frames.Num() > 0;
+}
+
+void UInputRecordingSubsystem::SaveRecording() const
+{
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+
+	uint32 Magic = RecordingMagic;
+	uint32 Version = RecordingVersion;
+	FString RecordedMapName = MapName;
+	TArray<FRecordedInputFrame> RecordedFrames = Frames;
+	Writer << Magic << Version << RecordedMapName << RecordedFrames;
+
+	const FString Path = FPaths::ProjectSavedDir() / TEXT("InputRecordings") / FString::Printf(TEXT("%s-%s.uinput"), *FPackageName::GetShortName(MapName), *FDateTime::Now().ToString());
+
+	if (FFileHelper::SaveArrayToFile(Data, *Path))
+		UE_LOG(LogTemp, Log, TEXT("Recorded %d frames of input to %s"), Frames.Num(), *Path);
+}
+
+AUdemyProjectCharacter* UInputRecordingSubsystem::GetLocalCharacter() const
+{
+	const UWorld* World = GetWorld();
+	const APlayerController* PlayerController = World != nullptr ? World->GetFirstPlayerController() : nullptr;
+
+	if (PlayerController == nullptr || !PlayerController->IsLocalController())
+		return nullptr;
+
+	return Cast<AUdemyProjectCharacter>(PlayerController->GetPawn());
+}
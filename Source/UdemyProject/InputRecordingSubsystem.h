@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InputRecordingSubsystem.generated.h"
+
+class AUdemyProjectCharacter;
+
+/** Input of the local character over one frame */
+struct FRecordedInputFrame
+{
+	enum EButton : uint8
+	{
+		DashStarted = 1 << 0,
+		DashStopped = 1 << 1,
+		Dodge = 1 << 2,
+		JumpStarted = 1 << 3,
+		JumpStopped = 1 << 4,
+	};
+
+	float DeltaTime = 0.0f;
+	FVector2f Move = FVector2f::ZeroVector;
+	FVector2f Look = FVector2f::ZeroVector;
+	uint8 Buttons = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FRecordedInputFrame& Frame)
+	{
+		return Ar << Frame.DeltaTime << Frame.Move << Frame.Look << Frame.Buttons;
+	}
+};
+
+/**
+ * -RecordInput writes the input the local character received every frame to Saved/InputRecordings, one file per map.
+ * -ReplayInput=<file> plays such a file back against the local character with the recorded frame times,
+ * as fast as the machine runs, then writes the cost per frame of every UTickProfilerSubsystem category
+ * to Saved/Profiling and quits. With -nullrhi this is a movement benchmark that needs no GPU.
+ */
+UCLASS()
+class UDEMYPROJECT_API UInputRecordingSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Called by the local character's input handlers while recording
+	void RecordMove(const FVector2D& Value);
+	void RecordLook(const FVector2D& Value);
+	void RecordButton(FRecordedInputFrame::EButton Button);
+
+private:
+	bool LoadRecording(const FString& Path);
+	void SaveRecording() const;
+
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void FinishReplay();
+
+	AUdemyProjectCharacter* GetLocalCharacter() const;
+
+	FString MapName;
+
+	bool bRecording = false;
+	FRecordedInputFrame CurrentFrame;
+
+	bool bReplaying = false;
+	int32 ReplayIndex = 0;
+	double ReplayStartTime = 0.0;
+	double FrameStartTime = 0.0;
+	bool bFrameReplayed = false;
+
+	TArray<FRecordedInputFrame> Frames;
+
+	// Milliseconds of each replayed frame: the frame's work, then one column per ETickProfilerCategory
+	TArray<TArray<float>> ReplayTimings;
+
+	FDelegateHandle WorldTickStartHandle;
+};
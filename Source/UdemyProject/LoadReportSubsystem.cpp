@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LoadReportSubsystem.h"
+
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+bool ULoadReportSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("LoadReport")) && Super::ShouldCreateSubsystem(Outer);
+}
+
+void ULoadReportSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (InWorld.GetNetMode() != NM_DedicatedServer && InWorld.GetNetMode() != NM_ListenServer)
+		return;
+
+	ReportPath = FPaths::ProfilingDir() / FString::Printf(TEXT("LoadReport-%s-%s.csv"), *InWorld.GetMapName(), *FDateTime::Now().ToString());
+
+	FFileHelper::SaveStringToFile(TEXT("Time,Clients,FrameMsAvg,FrameMsMax,InBytesPerSecAvg,OutBytesPerSecAvg,OutBytesPerSecMax,Corrections\n"), *ReportPath);
+
+	UE_LOG(LogTemp, Log, TEXT("Writing load report to %s"), *ReportPath);
+}
+
+void ULoadReportSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (ReportPath.IsEmpty())
+		return;
+
+	// The server sleeps to hold its tick rate, only the time spent working counts
+	const double Work = FMath::Max(FApp::GetDeltaTime() - FApp::GetIdleTime(), 0.0);
+	++Frames;
+	WorkSeconds += Work;
+	MaxWorkSeconds = FMath::Max(MaxWorkSeconds, Work);
+
+	TimeSinceReport += DeltaTime;
+	if (TimeSinceReport >= ReportInterval)
+	{
+		WriteRow();
+		TimeSinceReport = 0.0f;
+	}
+}
+
+TStatId ULoadReportSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULoadReportSubsystem, STATGROUP_Tickables);
+}
+
+void ULoadReportSubsystem::WriteRow()
+{
+	UWorld* World = GetWorld();
+	UNetDriver* NetDriver = World != nullptr ? World->GetNetDriver() : nullptr;
+
+	int32 Clients = 0;
+	int64 InBytesPerSecond = 0;
+	int64 OutBytesPerSecond = 0;
+	int32 MaxOutBytesPerSecond = 0;
+
+	if (NetDriver != nullptr)
+	{
+		for (UNetConnection* Connection : NetDriver->ClientConnections)
+		{
+			if (Connection == nullptr)
+				continue;
+
+			++Clients;
+			InBytesPerSecond += Connection->InBytesPerSecond;
+			OutBytesPerSecond += Connection->OutBytesPerSecond;
+			MaxOutBytesPerSecond = FMath::Max(MaxOutBytesPerSecond, Connection->OutBytesPerSecond);
+		}
+	}
+
+	const int32 Divisor = FMath::Max(Clients, 1);
+
+	const FString Row = FString::Printf(TEXT("%.1f,%d,%.2f,%.2f,%lld,%lld,%d,%d\n"),
+		World != nullptr ? World->GetRealTimeSeconds() : 0.0f,
+		Clients,
+		Frames > 0 ? WorkSeconds * 1000.0 / Frames : 0.0,
+		MaxWorkSeconds * 1000.0,
+		InBytesPerSecond / Divisor,
+		OutBytesPerSecond / Divisor,
+		MaxOutBytesPerSecond,
+		Corrections);
+
+	FFileHelper::SaveStringToFile(Row, *ReportPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+
+	Frames = 0;
+	WorkSeconds = 0.0;
+	MaxWorkSeconds = 0.0;
+	Corrections = 0;
+}
@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LoadReportSubsystem.generated.h"
+
+/**
+ * Writes one CSV row per second on a server started with -LoadReport:
+ * game thread frame time, client count, bandwidth per connection and movement corrections.
+ * Each map gets its own file in Saved/Profiling, so the lobby and the game can be compared.
+ */
+UCLASS()
+class UDEMYPROJECT_API ULoadReportSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Called by the movement component when the server sends a client a correction */
+	void AddCorrection() { ++Corrections; }
+
+private:
+	void WriteRow();
+
+	FString ReportPath;
+
+	float ReportInterval = 1.0f;
+	float TimeSinceReport = 0.0f;
+
+	// Accumulated since the last row
+	int32 Frames = 0;
+	double WorkSeconds = 0.0;
+	double MaxWorkSeconds = 0.0;
+	int32 Corrections = 0;
+};
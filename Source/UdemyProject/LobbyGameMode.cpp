@@ -3,16 +3,20 @@
 
 #include "LobbyGameMode.h"
 #include "TimerManager.h"
+#include "HostMigrationSubsystem.h"
 #include "UdemyPlatformGameInstance.h"
+#include "LobbyGameState.h"
+#include "LobbyPlayerController.h"
+#include "LobbyPlayerState.h"
 
 ALobbyGameMode::ALobbyGameMode()
 {
 	// set default pawn class to our Blueprinted character
-	static ConstructorHelpers::FClassFinder<APawn> PlayerPawnBPClass(TEXT("/Game/Udemy/Character/BP_UdemyCharacter"));
-	if (PlayerPawnBPClass.Class != NULL)
-	{
-		DefaultPawnClass = PlayerPawnBPClass.Class;
-	}
+	DefaultPawnSoftClass = TSoftClassPtr<APawn>(FSoftObjectPath(TEXT("/Game/Udemy/Character/BP_UdemyCharacter.BP_UdemyCharacter_C")));
+
+	GameStateClass = ALobbyGameState::StaticClass();
+	PlayerStateClass = ALobbyPlayerState::StaticClass();
+	PlayerControllerClass = ALobbyPlayerController::StaticClass();
 }
 
 
@@ -22,10 +26,10 @@ void ALobbyGameMode::PostLogin(APlayerController* NewPlayer)
 
 	++NumberOfPlayers;
 
-	if (NumberOfPlayers >= 2)
-	{
-		GetWorldTimerManager().SetTimer(GameStartTimer, this, &ALobbyGameMode::StartGame, 20);
-	}
+	if (!FirstLoginTime.IsSet())
+		FirstLoginTime = FPlatformTime::Seconds();
+
+	UpdateCountdown();
 }
 
 void ALobbyGameMode::Logout(AController* Exiting)
@@ -33,15 +37,103 @@ void ALobbyGameMode::Logout(AController* Exiting)
 	Super::Logout(Exiting);
 
 	--NumberOfPlayers;
+
+	UpdateCountdown(Exiting);
+}
+
+void ALobbyGameMode::RestoreMigratedPlayer(AController* Player, const FPlayerSnapshot& Snapshot)
+{
+	Super::RestoreMigratedPlayer(Player, Snapshot);
+
+	ALobbyPlayerState* LobbyPlayerState = Player->GetPlayerState<ALobbyPlayerState>();
+	if (LobbyPlayerState != nullptr && Snapshot.bReady)
+		LobbyPlayerState->SetReady(true);
+}
+
+void ALobbyGameMode::InitGameState()
+{
+	Super::InitGameState();
+
+	ALobbyGameState* LobbyGameState = GetGameState<ALobbyGameState>();
+	if (LobbyGameState != nullptr)
+		LobbyGameState->SetGameMap(GameMap);
+}
+
+void ALobbyGameMode::UpdateCountdown(AController* Exiting)
+{
+	if (NumberOfPlayers < MinPlayers)
+	{
+		CancelCountdown();
+		return;
+	}
+
+	// The leaving player's state is still in the player array during Logout
+	const APlayerState* ExitingPlayerState = Exiting != nullptr ? Exiting->PlayerState.Get() : nullptr;
+
+	uint32 NumReady = 0;
+	for (APlayerState* PlayerState : GameState->PlayerArray)
+	{
+		const ALobbyPlayerState* LobbyPlayerState = Cast<ALobbyPlayerState>(PlayerState);
+		if (LobbyPlayerState != nullptr && LobbyPlayerState != ExitingPlayerState && LobbyPlayerState->IsReady())
+			++NumReady;
+	}
+
+	FTimerManager& TimerManager = GetWorldTimerManager();
+	const bool bRunning = TimerManager.IsTimerActive(GameStartTimer);
+
+	// Joining never pushes the start back, only everyone being ready brings it forward
+	float Remaining = bRunning ? TimerManager.GetTimerRemaining(GameStartTimer) : LobbyCountdown;
+	if (NumReady >= NumberOfPlayers)
+		Remaining = FMath::Min(Remaining, AllReadyCountdown);
+
+	if (!bRunning || Remaining < TimerManager.GetTimerRemaining(GameStartTimer))
+		SetCountdown(Remaining);
+}
+
+void ALobbyGameMode::SetCountdown(float Seconds)
+{
+	GetWorldTimerManager().SetTimer(GameStartTimer, this, &ALobbyGameMode::StartGame, FMath::Max(Seconds, UE_KINDA_SMALL_NUMBER));
+
+	ALobbyGameState* LobbyGameState = GetGameState<ALobbyGameState>();
+	if (LobbyGameState != nullptr)
+		LobbyGameState->SetCountdownEndTime(LobbyGameState->GetServerWorldTimeSeconds() + Seconds);
+}
+
+void ALobbyGameMode::CancelCountdown()
+{
+	if (GetWorldTimerManager().IsTimerActive(GameStartTimer))
+		UE_LOG(LogTemp, Log, TEXT("Lobby countdown aborted, %u of %u players"), NumberOfPlayers, MinPlayers);
+
+	GetWorldTimerManager().ClearTimer(GameStartTimer);
+
+	ALobbyGameState* LobbyGameState = GetGameState<ALobbyGameState>();
+	if (LobbyGameState != nullptr)
+		LobbyGameState->SetCountdownEndTime(0.0);
 }
 
 void ALobbyGameMode::StartGame()
 {
+	if (NumberOfPlayers < MinPlayers)
+		return;
+
 	auto GameInstance = Cast<UUdemyPlatformGameInstance>(GetGameInstance());
 
 	if (GameInstance == nullptr)
 		return;
 
+	if (FirstLoginTime.IsSet())
+		UE_LOG(LogTemp, Log, TEXT("Lobby launched %.1f s after the first login with %u players"), FPlatformTime::Seconds() - FirstLoginTime.GetValue(), NumberOfPlayers);
+
+	// Players who have not finished preloading load the rest during the travel
+	for (APlayerState* PlayerState : GameState->PlayerArray)
+	{
+		const ALobbyPlayerState* LobbyPlayerState = Cast<ALobbyPlayerState>(PlayerState);
+		if (LobbyPlayerState != nullptr && LobbyPlayerState->GetPreloadPercent() < 100)
+			UE_LOG(LogTemp, Log, TEXT("%s travels with %d%% of %s preloaded"), *LobbyPlayerState->GetPlayerName(), LobbyPlayerState->GetPreloadPercent(), *GameMap);
+	}
+
+	CancelCountdown();
+
 	GameInstance->StartSession();
 
 	UWorld* World = GetWorld();
@@ -50,5 +142,6 @@ void ALobbyGameMode::StartGame()
 		return;
 
 	bUseSeamlessTravel = true;
-	World->ServerTravel("/Game/ThirdPerson/Maps/ThirdPersonMap?listen");
-}
\ No newline at end of file
+	// A dedicated server already listens
+	World->ServerTravel(GetNetMode() == NM_DedicatedServer ? GameMap : GameMap + TEXT("?listen"));
+}
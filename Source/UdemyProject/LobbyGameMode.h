@@ -7,7 +7,9 @@
 #include "LobbyGameMode.generated.h"
 
 /**
- * 
+ * Starts the game after a countdown once MinPlayers are in the lobby.
+ * Later logins do not restart the countdown, everyone being ready shortens it,
+ * and it is cancelled when players leave below the minimum.
  */
 UCLASS()
 class UDEMYPROJECT_API ALobbyGameMode : public AUdemyProjectGameMode
@@ -22,10 +24,39 @@ public:
 
 	void Logout(AController* Exiting) override;
 
+	void InitGameState() override;
+
+	/** Starts, shortens or cancels the countdown for the current players and ready flags */
+	void UpdateCountdown(AController* Exiting = nullptr);
+
+protected:
+	/** Also restores the ready flag */
+	virtual void RestoreMigratedPlayer(AController* Player, const FPlayerSnapshot& Snapshot) override;
+
 private:
 	void StartGame();
 
+	void SetCountdown(float Seconds);
+	void CancelCountdown();
+
+	UPROPERTY(EditDefaultsOnly, Category = "Lobby")
+	uint32 MinPlayers = 2;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Lobby")
+	float LobbyCountdown = 20.0f;
+
+	// Countdown left once every player is ready
+	UPROPERTY(EditDefaultsOnly, Category = "Lobby")
+	float AllReadyCountdown = 3.0f;
+
+	// Preloaded by the server and every client while they wait in the lobby
+	UPROPERTY(EditDefaultsOnly, Category = "Lobby")
+	FString GameMap = TEXT("/Game/ThirdPerson/Maps/ThirdPersonMap");
+
 	uint32 NumberOfPlayers = 0;
 
 	FTimerHandle GameStartTimer;
+
+	// For the fill to launch time in the log
+	TOptional<double> FirstLoginTime;
 };
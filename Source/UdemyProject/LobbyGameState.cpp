@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LobbyGameState.h"
+
+#include "Net/UnrealNetwork.h"
+
+#include "LobbyPlayerState.h"
+#include "MapPreloadSubsystem.h"
+
+void ALobbyGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ALobbyGameState, CountdownEndTime);
+	DOREPLIFETIME_CONDITION(ALobbyGameState, GameMap, COND_InitialOnly);
+}
+
+void ALobbyGameState::SetCountdownEndTime(double EndServerTime)
+{
+	CountdownEndTime = FMath::Max(EndServerTime, 0.0);
+	ForceNetUpdate();
+}
+
+float ALobbyGameState::GetCountdownRemaining() const
+{
+	if (!IsCountdownRunning())
+		return 0.0f;
+
+	return FMath::Max((float)(CountdownEndTime - GetServerWorldTimeSeconds()), 0.0f);
+}
+
+int32 ALobbyGameState::GetNumReadyPlayers() const
+{
+	int32 NumReady = 0;
+
+	for (APlayerState* PlayerState : PlayerArray)
+	{
+		ALobbyPlayerState* LobbyPlayerState = Cast<ALobbyPlayerState>(PlayerState);
+		if (LobbyPlayerState != nullptr && LobbyPlayerState->IsReady())
+			++NumReady;
+	}
+
+	return NumReady;
+}
+
+void ALobbyGameState::SetGameMap(const FString& MapPackageName)
+{
+	GameMap = MapPackageName;
+
+	OnRep_GameMap();
+}
+
+void ALobbyGameState::OnRep_GameMap()
+{
+	UGameInstance* GameInstance = GetGameInstance();
+	UMapPreloadSubsystem* MapPreload = GameInstance != nullptr ? GameInstance->GetSubsystem<UMapPreloadSubsystem>() : nullptr;
+	if (MapPreload != nullptr)
+		MapPreload->Preload(GameMap);
+}
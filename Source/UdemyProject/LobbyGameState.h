@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UdemyProjectGameState.h"
+#include "LobbyGameState.generated.h"
+
+/**
+ * Replicates the lobby countdown as an end time in server world time,
+ * so clients estimate the remaining seconds locally instead of receiving a value every second.
+ */
+UCLASS()
+class UDEMYPROJECT_API ALobbyGameState : public AUdemyProjectGameState
+{
+	GENERATED_BODY()
+
+public:
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Server only. A non-positive end time stops the countdown. */
+	void SetCountdownEndTime(double EndServerTime);
+
+	UFUNCTION(BlueprintCallable)
+	bool IsCountdownRunning() const { return CountdownEndTime > 0.0; }
+
+	/** Seconds until the game starts, 0 while no countdown runs */
+	UFUNCTION(BlueprintCallable)
+	float GetCountdownRemaining() const;
+
+	UFUNCTION(BlueprintCallable)
+	int32 GetNumReadyPlayers() const;
+
+	/** Server only. Everyone starts preloading the map the lobby will travel to. */
+	void SetGameMap(const FString& MapPackageName);
+
+private:
+	UPROPERTY(Replicated)
+	double CountdownEndTime = 0.0;
+
+	UPROPERTY(ReplicatedUsing = OnRep_GameMap)
+	FString GameMap;
+
+	UFUNCTION()
+	void OnRep_GameMap();
+};
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LobbyPlayerController.h"
+
+#include "TimerManager.h"
+
+#include "LobbyPlayerState.h"
+#include "MapPreloadSubsystem.h"
+
+void ALobbyPlayerController::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (IsLocalController())
+		GetWorldTimerManager().SetTimer(PreloadReportTimer, this, &ALobbyPlayerController::ReportPreloadProgress, 0.25f, true);
+}
+
+void ALobbyPlayerController::ToggleReady()
+{
+	ALobbyPlayerState* LobbyPlayerState = GetPlayerState<ALobbyPlayerState>();
+	if (LobbyPlayerState == nullptr)
+		return;
+
+	ServerSetReady(!LobbyPlayerState->IsReady());
+}
+
+void ALobbyPlayerController::ServerSetReady_Implementation(bool bReady)
+{
+	ALobbyPlayerState* LobbyPlayerState = GetPlayerState<ALobbyPlayerState>();
+	if (LobbyPlayerState != nullptr)
+		LobbyPlayerState->SetReady(bReady);
+}
+
+void ALobbyPlayerController::ReportPreloadProgress()
+{
+	UMapPreloadSubsystem* MapPreload = GetGameInstance() != nullptr ? GetGameInstance()->GetSubsystem<UMapPreloadSubsystem>() : nullptr;
+	if (MapPreload == nullptr)
+		return;
+
+	const uint8 Percent = (uint8)FMath::FloorToInt(MapPreload->GetProgress() * 100.0f);
+	if (Percent == 100 || Percent >= LastReportedPreloadPercent + PreloadReportStep)
+	{
+		LastReportedPreloadPercent = Percent;
+		ServerReportPreloadProgress(Percent);
+	}
+
+	if (Percent == 100)
+		GetWorldTimerManager().ClearTimer(PreloadReportTimer);
+}
+
+void ALobbyPlayerController::ServerReportPreloadProgress_Implementation(uint8 Percent)
+{
+	ALobbyPlayerState* LobbyPlayerState = GetPlayerState<ALobbyPlayerState>();
+	if (LobbyPlayerState != nullptr)
+		LobbyPlayerState->SetPreloadPercent(Percent);
+}
@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerController.h"
+#include "LobbyPlayerController.generated.h"
+
+/**
+ * 
+ */
+UCLASS()
+class UDEMYPROJECT_API ALobbyPlayerController : public APlayerController
+{
+	GENERATED_BODY()
+
+public:
+	virtual void BeginPlay() override;
+
+	UFUNCTION(Exec, BlueprintCallable)
+	void ToggleReady();
+
+private:
+	UFUNCTION(Server, Reliable)
+	void ServerSetReady(bool bReady);
+
+	// Sent in steps of PreloadReportStep percent, not every poll
+	UFUNCTION(Server, Reliable)
+	void ServerReportPreloadProgress(uint8 Percent);
+
+	void ReportPreloadProgress();
+
+	FTimerHandle PreloadReportTimer;
+	uint8 LastReportedPreloadPercent = 0;
+	uint8 PreloadReportStep = 10;
+};
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LobbyPlayerState.h"
+
+#include "Net/UnrealNetwork.h"
+
+#include "LobbyGameMode.h"
+#include "NetStatsSubsystem.h"
+
+void ALobbyPlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ALobbyPlayerState, bIsReady);
+	DOREPLIFETIME(ALobbyPlayerState, PreloadPercent);
+}
+
+void ALobbyPlayerState::PostNetReceive()
+{
+	Super::PostNetReceive();
+
+	if (UNetStatsSubsystem* NetStats = GetWorld()->GetSubsystem<UNetStatsSubsystem>())
+		NetStats->RecordPropertyUpdate(this);
+}
+
+void ALobbyPlayerState::SetReady(bool bReady)
+{
+	if (!HasAuthority() || bIsReady == bReady)
+		return;
+
+	bIsReady = bReady;
+	ForceNetUpdate();
+
+	ALobbyGameMode* GameMode = GetWorld()->GetAuthGameMode<ALobbyGameMode>();
+	if (GameMode != nullptr)
+		GameMode->UpdateCountdown();
+}
+
+void ALobbyPlayerState::SetPreloadPercent(uint8 Percent)
+{
+	if (!HasAuthority())
+		return;
+
+	PreloadPercent = FMath::Min<uint8>(Percent, 100);
+}
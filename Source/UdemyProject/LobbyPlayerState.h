@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerState.h"
+#include "LobbyPlayerState.generated.h"
+
+/**
+ * Ready flag of a player in the lobby
+ */
+UCLASS()
+class UDEMYPROJECT_API ALobbyPlayerState : public APlayerState
+{
+	GENERATED_BODY()
+
+public:
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// Counted by UNetStatsSubsystem
+	virtual void PostNetReceive() override;
+
+	UFUNCTION(BlueprintCallable)
+	bool IsReady() const { return bIsReady; }
+
+	/** Server only, the game mode is told so it can start or stop the countdown */
+	void SetReady(bool bReady);
+
+	/** How much of the game map this player has loaded in the background */
+	UFUNCTION(BlueprintCallable)
+	uint8 GetPreloadPercent() const { return PreloadPercent; }
+
+	/** Server only */
+	void SetPreloadPercent(uint8 Percent);
+
+private:
+	UPROPERTY(Replicated)
+	bool bIsReady = false;
+
+	UPROPERTY(Replicated)
+	uint8 PreloadPercent = 0;
+};
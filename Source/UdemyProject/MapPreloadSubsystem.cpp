@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MapPreloadSubsystem.h"
+
+#include "Engine/World.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+
+void UMapPreloadSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	SeamlessTravelStartHandle = FWorldDelegates::OnSeamlessTravelStart.AddUObject(this, &UMapPreloadSubsystem::OnSeamlessTravelStart);
+	PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddUObject(this, &UMapPreloadSubsystem::OnPreLoadMap);
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UMapPreloadSubsystem::OnPostLoadMap);
+}
+
+void UMapPreloadSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnSeamlessTravelStart.Remove(SeamlessTravelStartHandle);
+	FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+
+	Super::Deinitialize();
+}
+
+void UMapPreloadSubsystem::Preload(const FString& MapPackageName)
+{
+	if (MapPackageName.IsEmpty())
+		return;
+
+	if (MapPackageName == PreloadPackageName && (bLoading || PreloadedWorld != nullptr))
+		return;
+
+	PreloadPackageName = MapPackageName;
+	PreloadedWorld = nullptr;
+
+	// Already in memory, e.g. the host of a listen server asked for it through the game state and the game mode
+	if (UPackage* LoadedPackage = FindPackage(nullptr, *MapPackageName))
+	{
+		if (LoadedPackage->IsFullyLoaded())
+		{
+			PreloadedWorld = UWorld::FindWorldInPackage(LoadedPackage);
+			if (PreloadedWorld != nullptr)
+				return;
+		}
+	}
+
+	bLoading = true;
+	PreloadStartTime = FPlatformTime::Seconds();
+
+	LoadPackageAsync(MapPackageName, FLoadPackageAsyncDelegate::CreateUObject(this, &UMapPreloadSubsystem::OnPackageLoaded));
+}
+
+float UMapPreloadSubsystem::GetProgress() const
+{
+	if (PreloadedWorld != nullptr)
+		return 1.0f;
+
+	if (!bLoading)
+		return 0.0f;
+
+	// Negative while the request is still queued
+	return FMath::Clamp(GetAsyncLoadPercentage(*PreloadPackageName) / 100.0f, 0.0f, 1.0f);
+}
+
+void UMapPreloadSubsystem::OnPackageLoaded(const FName& PackageName, UPackage* Package, EAsyncLoadingResult::Type Result)
+{
+	if (PackageName.ToString() != PreloadPackageName)
+		return;
+
+	bLoading = false;
+
+	if (Result != EAsyncLoadingResult::Succeeded || Package == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Could not preload %s"), *PreloadPackageName);
+		return;
+	}
+
+	// The world references its levels and actors and through them every dependency, so it alone keeps the map in memory
+	PreloadedWorld = UWorld::FindWorldInPackage(Package);
+	if (PreloadedWorld == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s is not a map"), *PreloadPackageName);
+		return;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Preloaded %s in %.0f ms"), *PreloadPackageName, (FPlatformTime::Seconds() - PreloadStartTime) * 1000.0);
+}
+
+void UMapPreloadSubsystem::OnSeamlessTravelStart(UWorld* World, const FString& MapName)
+{
+	StartTravelTiming(MapName);
+}
+
+void UMapPreloadSubsystem::OnPreLoadMap(const FString& MapName)
+{
+	// Seamless travel already started timing at its own start
+	if (!TravelStartTime.IsSet())
+		StartTravelTiming(MapName);
+}
+
+void UMapPreloadSubsystem::StartTravelTiming(const FString& MapName)
+{
+	TravelStartTime = FPlatformTime::Seconds();
+	TravelPackageName = FPackageName::ObjectPathToPackageName(MapName);
+	bTravelPreloaded = PreloadedWorld != nullptr && TravelPackageName == PreloadPackageName;
+}
+
+void UMapPreloadSubsystem::OnPostLoadMap(UWorld* World)
+{
+	if (World == nullptr)
+		return;
+
+	const FString LoadedPackageName = UWorld::RemovePIEPrefix(World->GetOutermost()->GetName());
+
+	// The transition map of a seamless travel is only a stop on the way
+	if (TravelStartTime.IsSet() && LoadedPackageName == TravelPackageName)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Travel to %s took %.0f ms (%s)"), *LoadedPackageName, (FPlatformTime::Seconds() - TravelStartTime.GetValue()) * 1000.0, bTravelPreloaded ? TEXT("preloaded") : TEXT("not preloaded"));
+		TravelStartTime.Reset();
+	}
+
+	// The world now references everything it needs
+	if (LoadedPackageName == PreloadPackageName)
+	{
+		PreloadedWorld = nullptr;
+		PreloadPackageName.Empty();
+	}
+}
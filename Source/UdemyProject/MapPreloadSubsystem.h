@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "MapPreloadSubsystem.generated.h"
+
+class UPackage;
+class UWorld;
+
+/**
+ * Loads the next map's package and its dependencies in the background while players wait in the lobby,
+ * so the travel only has to create the world from packages already in memory.
+ * The loaded world is held until the map is loaded, then released to the normal garbage collection.
+ * Holding only the package would not do, a package does not reference the objects inside it.
+ * Also logs how long each travel took from start to the loaded map, and whether it was preloaded.
+ */
+UCLASS()
+class UDEMYPROJECT_API UMapPreloadSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Starts loading the map package, e.g. "/Game/ThirdPerson/Maps/ThirdPersonMap". Does nothing if already loading or loaded. */
+	void Preload(const FString& MapPackageName);
+
+	/** 0 to 1 for the map passed to Preload */
+	float GetProgress() const;
+
+	bool IsPreloaded() const { return PreloadedWorld != nullptr; }
+
+private:
+	void OnPackageLoaded(const FName& PackageName, UPackage* Package, EAsyncLoadingResult::Type Result);
+
+	void OnSeamlessTravelStart(UWorld* World, const FString& MapName);
+	void OnPreLoadMap(const FString& MapName);
+	void OnPostLoadMap(UWorld* World);
+
+	void StartTravelTiming(const FString& MapName);
+
+	FString PreloadPackageName;
+	bool bLoading = false;
+	double PreloadStartTime = 0.0;
+
+	UPROPERTY()
+	TObjectPtr<UWorld> PreloadedWorld = nullptr;
+
+	TOptional<double> TravelStartTime;
+	FString TravelPackageName;
+	bool bTravelPreloaded = false;
+
+	FDelegateHandle SeamlessTravelStartHandle;
+	FDelegateHandle PreLoadMapHandle;
+	FDelegateHandle PostLoadMapHandle;
+};
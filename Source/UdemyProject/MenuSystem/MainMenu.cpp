@@ -3,23 +3,13 @@
 
 #include "MainMenu.h"
 
-#include "UObject/ConstructorHelpers.h"
-
 #include "Components/Button.h"
 #include "Components/WidgetSwitcher.h"
 #include "Components/EditableTextBox.h"
-#include "Components/TextBlock.h"
-
-#include "ServerRow.h"
+#include "Components/ListView.h"
+#include "TimerManager.h"
 
-UMainMenu::UMainMenu(const FObjectInitializer& ObjectInitializer)
-{
-	ConstructorHelpers::FClassFinder<UUserWidget> ServerRowBPClass(TEXT("/Game/Udemy/WBP_ServerRow"));
-	if (ServerRowBPClass.Class != nullptr)
-	{
-		ServerRowClass = ServerRowBPClass.Class;
-	}
-}
+#include "ServerListItem.h"
 
 bool UMainMenu::Initialize()
 {
@@ -63,6 +53,32 @@ bool UMainMenu::Initialize()
 
 	ExitButton->OnClicked.AddDynamic(this, &UMainMenu::ExitPressed);
 
+	if (!ensure(ServerList != nullptr))
+		return false;
+
+	ServerList->OnItemSelectionChanged().AddUObject(this, &UMainMenu::SelectionChanged);
+
+	if (QuickMatchButton != nullptr)
+		QuickMatchButton->OnClicked.AddDynamic(this, &UMainMenu::QuickMatch);
+
+	if (ServerFilter != nullptr)
+		ServerFilter->OnTextChanged.AddDynamic(this, &UMainMenu::FilterChanged);
+
+	if (SortByScoreButton != nullptr)
+		SortByScoreButton->OnClicked.AddDynamic(this, &UMainMenu::SortByScore);
+
+	if (SortByNameButton != nullptr)
+		SortByNameButton->OnClicked.AddDynamic(this, &UMainMenu::SortByName);
+
+	if (SortByFillButton != nullptr)
+		SortByFillButton->OnClicked.AddDynamic(this, &UMainMenu::SortByFill);
+
+	if (SortByPingButton != nullptr)
+		SortByPingButton->OnClicked.AddDynamic(this, &UMainMenu::SortByPing);
+
+	if (SortByHostButton != nullptr)
+		SortByHostButton->OnClicked.AddDynamic(this, &UMainMenu::SortByHost);
+
 	return true;
 }
 
@@ -80,54 +96,171 @@ void UMainMenu::HostServer()
 	}
 }
 
-void UMainMenu::SetServerList(TArray<FServerData> ServerName)
+void UMainMenu::SetServerList(const TArray<FServerData>& ServerData)
 {
-	ServerList->ClearChildren();
+	ServerListModel.SetEntries(ServerData);
 
-	uint32 i = 0;
-	for (const FServerData& ServerData : ServerName)
+	TSet<FString> IncomingIds;
+	IncomingIds.Reserve(ServerData.Num());
+	for (const FServerData& Data : ServerData)
 	{
-		UServerRow* ServerRow = CreateWidget<UServerRow>(this, ServerRowClass);
+		IncomingIds.Add(Data.SessionId);
+	}
+
+	// Items of sessions that disappeared go back to the pool
+	for (auto It = ItemsBySessionId.CreateIterator(); It; ++It)
+	{
+		if (!IncomingIds.Contains(It.Key()))
+		{
+			ItemPool.Push(It.Value());
+			It.RemoveCurrent();
+		}
+	}
 
-		if (!ensure(ServerRow != nullptr))
-			return;
+	for (const FServerData& Data : ServerData)
+	{
+		UServerListItem* Item = nullptr;
 
-		ServerRow->ServerName->SetText(FText::FromString(ServerData.Name));
-		ServerRow->HostUser->SetText(FText::FromString(ServerData.HostUserName));
-		
-		FString FractionText = FString::Printf(TEXT("%d/%d"), ServerData.CurrentPlayers, ServerData.MaxPlayers);
-		ServerRow->ConnectionFraction->SetText(FText::FromString(FractionText));
-		ServerRow->Setup(this, i);
-		++i;
+		if (UServerListItem** ExistingItem = ItemsBySessionId.Find(Data.SessionId))
+		{
+			Item = *ExistingItem;
+		}
+		else
+		{
+			Item = AcquireItem();
+			ItemsBySessionId.Add(Data.SessionId, Item);
+		}
 
-		ServerList->AddChild(ServerRow);
+		Item->SetData(Data);
 	}
+
+	RefreshListView();
 }
 
-void UMainMenu::SelectIndex(uint32 Index)
+void UMainMenu::UpdateServer(const FServerData& ServerData)
 {
-	SelectedIndex = Index;
-	UpdateChildren();
+	if (!ServerListModel.UpdateEntry(ServerData))
+		return;
+
+	if (UServerListItem* Item = ItemsBySessionId.FindRef(ServerData.SessionId))
+		Item->SetData(ServerData);
+
+	RefreshListViewNextTick();
 }
 
-void UMainMenu::UpdateChildren()
+UServerListItem* UMainMenu::AcquireItem()
 {
-	for (int32 i = 0; i < ServerList->GetChildrenCount(); i++)
+	if (ItemPool.Num() > 0)
+		return ItemPool.Pop(false);
+
+	return NewObject<UServerListItem>(this);
+}
+
+void UMainMenu::RefreshListViewNextTick()
+{
+	if (bRefreshPending)
+		return;
+
+	UWorld* World = GetWorld();
+	if (World == nullptr)
+		return;
+
+	// Latency results arrive one by one, sort and rebuild the view once for all of this frame's results
+	bRefreshPending = true;
+	World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateWeakLambda(this, [this]()
 	{
-		auto Row = Cast<UServerRow>(ServerList->GetChildAt(i));
-		if (Row != nullptr)
-		{
-			Row->Selected = (SelectedIndex.IsSet() && SelectedIndex.GetValue() == i);
-		}
+		bRefreshPending = false;
+		ServerListModel.RebuildView();
+		RefreshListView();
+	}));
+}
+
+void UMainMenu::RefreshListView()
+{
+	const TArray<FServerData>& Entries = ServerListModel.GetEntries();
+	const TArray<int32>& View = ServerListModel.GetView();
+
+	TArray<UServerListItem*> Items;
+	Items.Reserve(View.Num());
+
+	UServerListItem* SelectedItem = nullptr;
+
+	for (int32 EntryIndex : View)
+	{
+		UServerListItem* Item = ItemsBySessionId.FindRef(Entries[EntryIndex].SessionId);
+		if (Item == nullptr)
+			continue;
+
+		Items.Add(Item);
+
+		if (SelectedSessionId.IsSet() && SelectedSessionId.GetValue() == Item->GetData().SessionId)
+			SelectedItem = Item;
 	}
+
+	// Entry widgets are kept and only reassigned where the order changed, changed data reaches them through the item
+	ServerList->SetListItems(Items);
+	ServerList->RequestRefresh();
+
+	if (SelectedItem != nullptr)
+		ServerList->SetSelectedItem(SelectedItem);
+	else
+		ServerList->ClearSelection();
+}
+
+void UMainMenu::SelectionChanged(UObject* Item)
+{
+	UServerListItem* ServerItem = Cast<UServerListItem>(Item);
+
+	if (ServerItem != nullptr)
+		SelectedSessionId = ServerItem->GetData().SessionId;
+	else
+		SelectedSessionId.Reset();
+}
+
+void UMainMenu::FilterChanged(const FText& Text)
+{
+	ServerListModel.SetFilter(Text.ToString());
+	RefreshListView();
+}
+
+void UMainMenu::SortByScore()
+{
+	ServerListModel.SetSortKey(EServerSortKey::Score);
+	RefreshListView();
+}
+
+void UMainMenu::SortByName()
+{
+	ServerListModel.SetSortKey(EServerSortKey::Name);
+	RefreshListView();
+}
+
+void UMainMenu::SortByFill()
+{
+	ServerListModel.SetSortKey(EServerSortKey::Fill);
+	RefreshListView();
+}
+
+void UMainMenu::SortByPing()
+{
+	ServerListModel.SetSortKey(EServerSortKey::Ping);
+	RefreshListView();
+}
+
+void UMainMenu::SortByHost()
+{
+	ServerListModel.SetSortKey(EServerSortKey::Host);
+	RefreshListView();
 }
 
 void UMainMenu::JoinServer()
 {
-	if (SelectedIndex.IsSet() && MenuInterface != nullptr)
+	UServerListItem* SelectedItem = ServerList->GetSelectedItem<UServerListItem>();
+
+	if (SelectedItem != nullptr && MenuInterface != nullptr)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Selected Index %d."), SelectedIndex.GetValue());
-		MenuInterface->Join(SelectedIndex.GetValue());
+		UE_LOG(LogTemp, Warning, TEXT("Selected Index %d."), SelectedItem->GetData().SearchResultIndex);
+		MenuInterface->Join(SelectedItem->GetData().SearchResultIndex);
 	}
 	else
 	{
@@ -135,6 +268,14 @@ void UMainMenu::JoinServer()
 	}
 }
 
+void UMainMenu::QuickMatch()
+{
+	if (MenuInterface != nullptr)
+	{
+		MenuInterface->QuickMatch();
+	}
+}
+
 void UMainMenu::OpenJoinMenu()
 {
 
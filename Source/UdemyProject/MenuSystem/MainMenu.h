@@ -4,19 +4,10 @@
 
 #include "CoreMinimal.h"
 #include "MenuWidget.h"
+#include "ServerData.h"
+#include "ServerListModel.h"
 #include "MainMenu.generated.h"
 
-USTRUCT()
-struct FServerData
-{
-	GENERATED_BODY()
-
-	FString Name;
-	uint16 CurrentPlayers;
-	uint16 MaxPlayers;
-	FString HostUserName;
-};
-
 /**
  * 
  */
@@ -26,18 +17,15 @@ class UDEMYPROJECT_API UMainMenu : public UMenuWidget
 	GENERATED_BODY()
 
 public:
-	UMainMenu(const FObjectInitializer& ObjectInitializer);
+	void SetServerList(const TArray<FServerData>& ServerData);
 
-	void SetServerList(TArray<FServerData> ServerName);
-
-	void SelectIndex(uint32 Index);
+	/** Updates one session in place, e.g. when its latency was measured. Refreshes once per frame at most. */
+	void UpdateServer(const FServerData& ServerData);
 
 protected:
 	virtual bool Initialize();
 
 private:
-	TSubclassOf<class UUserWidget> ServerRowClass;
-
 	UPROPERTY(meta = (BindWidget))
 	class UButton* HostButton;
 
@@ -74,8 +62,30 @@ private:
 	UPROPERTY(meta = (BindWidget))
 	class UButton* ConfirmHostMenuButton;
 
+	/** List view with WBP_ServerRow as entry widget, only visible rows are built */
 	UPROPERTY(meta = (BindWidget))
-	class UPanelWidget* ServerList;
+	class UListView* ServerList;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	class UButton* QuickMatchButton;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	class UEditableTextBox* ServerFilter;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	class UButton* SortByScoreButton;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	class UButton* SortByNameButton;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	class UButton* SortByFillButton;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	class UButton* SortByPingButton;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	class UButton* SortByHostButton;
 
 	UFUNCTION()
 	void HostServer();
@@ -83,6 +93,9 @@ private:
 	UFUNCTION()
 	void JoinServer();
 
+	UFUNCTION()
+	void QuickMatch();
+
 	UFUNCTION()
 	void OpenHostMenu();
 
@@ -95,7 +108,43 @@ private:
 	UFUNCTION()
 	void ExitPressed();
 
-	TOptional<uint32> SelectedIndex;
+	UFUNCTION()
+	void FilterChanged(const FText& Text);
+
+	UFUNCTION()
+	void SortByScore();
+
+	UFUNCTION()
+	void SortByName();
+
+	UFUNCTION()
+	void SortByFill();
+
+	UFUNCTION()
+	void SortByPing();
+
+	UFUNCTION()
+	void SortByHost();
+
+	void SelectionChanged(UObject* Item);
+
+	FServerListModel ServerListModel;
+
+	// Selection follows the session, not the row position, across refreshes
+	TOptional<FString> SelectedSessionId;
+
+	// Items of the sessions in the model, keyed by session id
+	UPROPERTY()
+	TMap<FString, class UServerListItem*> ItemsBySessionId;
+
+	// Items of sessions that disappeared, reused before any new item is created
+	UPROPERTY()
+	TArray<class UServerListItem*> ItemPool;
+
+	class UServerListItem* AcquireItem();
+
+	void RefreshListView();
 
-	void UpdateChildren();
+	bool bRefreshPending = false;
+	void RefreshListViewNextTick();
 };
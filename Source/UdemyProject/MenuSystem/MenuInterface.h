@@ -29,4 +29,7 @@ public:
 	virtual void LoadMainMenu() = 0;
 
 	virtual void RefreshServerList() = 0;
+
+	/** Joins the best session found, or hosts one if none is suitable */
+	virtual void QuickMatch() = 0;
 };
@@ -5,7 +5,9 @@
 
 void UMenuWidget::Setup()
 {
-	this->AddToViewport();
+	// Cached menus are shown again without being recreated
+	if (!this->IsInViewport())
+		this->AddToViewport();
 
 	UWorld* World = GetWorld();
 	if (!ensure(World != nullptr))
@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ServerData.generated.h"
+
+USTRUCT()
+struct FServerData
+{
+	GENERATED_BODY()
+
+	// Key used to diff refreshed search results against the rows already shown
+	FString SessionId;
+
+	FString Name;
+	uint16 CurrentPlayers = 0;
+	uint16 MaxPlayers = 0;
+	FString HostUserName;
+	int32 PingInMs = 0;
+
+	// Position in the session search results, passed back to IMenuInterface::Join
+	uint32 SearchResultIndex = 0;
+};
@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "ServerData.h"
+#include "ServerListItem.generated.h"
+
+/**
+ * List view item for one session. Entry widgets are only created for visible items,
+ * the one showing this item is told when its data changes instead of the list rebuilding its entries.
+ */
+UCLASS()
+class UDEMYPROJECT_API UServerListItem : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	DECLARE_MULTICAST_DELEGATE(FOnDataChanged);
+
+	const FServerData& GetData() const { return Data; }
+
+	void SetData(const FServerData& InData)
+	{
+		Data = InData;
+		OnDataChanged.Broadcast();
+	}
+
+	FOnDataChanged OnDataChanged;
+
+private:
+	FServerData Data;
+};
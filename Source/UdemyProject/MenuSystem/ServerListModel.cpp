@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ServerListModel.h"
+
+namespace
+{
+	// How many milliseconds of ping an empty session is worth compared to a nearly full one
+	constexpr float EmptySessionPenaltyMs = 100.0f;
+	constexpr float FullSessionPenaltyMs = 100000.0f;
+
+	float GetFillRatio(const FServerData& Entry)
+	{
+		return Entry.MaxPlayers > 0 ? (float)Entry.CurrentPlayers / Entry.MaxPlayers : 1.0f;
+	}
+}
+
+void FServerListModel::SetEntries(const TArray<FServerData>& InEntries)
+{
+	Entries = InEntries;
+
+	EntryIndexBySessionId.Reset();
+	EntryIndexBySessionId.Reserve(Entries.Num());
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		EntryIndexBySessionId.Add(Entries[i].SessionId, i);
+	}
+
+	RebuildView();
+}
+
+bool FServerListModel::UpdateEntry(const FServerData& Entry)
+{
+	const int32* Index = EntryIndexBySessionId.Find(Entry.SessionId);
+	if (Index == nullptr)
+		return false;
+
+	Entries[*Index] = Entry;
+
+	return true;
+}
+
+void FServerListModel::SetFilter(const FString& InFilter)
+{
+	Filter = InFilter.TrimStartAndEnd();
+	RebuildView();
+}
+
+void FServerListModel::SetSortKey(EServerSortKey InSortKey)
+{
+	if (SortKey == InSortKey)
+	{
+		bAscending = !bAscending;
+	}
+	else
+	{
+		SortKey = InSortKey;
+		bAscending = true;
+	}
+
+	RebuildView();
+}
+
+void FServerListModel::RebuildView()
+{
+	View.Reset(Entries.Num());
+
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		if (PassesFilter(Entries[i]))
+			View.Add(i);
+	}
+
+	View.StableSort([this](int32 A, int32 B) { return IsBefore(Entries[A], Entries[B]); });
+}
+
+float FServerListModel::GetScore(const FServerData& Entry)
+{
+	if (Entry.MaxPlayers > 0 && Entry.CurrentPlayers >= Entry.MaxPlayers)
+		return FullSessionPenaltyMs + Entry.PingInMs;
+
+	return Entry.PingInMs + (1.0f - GetFillRatio(Entry)) * EmptySessionPenaltyMs;
+}
+
+bool FServerListModel::PassesFilter(const FServerData& Entry) const
+{
+	if (Filter.IsEmpty())
+		return true;
+
+	return Entry.Name.Contains(Filter) || Entry.HostUserName.Contains(Filter);
+}
+
+bool FServerListModel::IsBefore(const FServerData& A, const FServerData& B) const
+{
+	const FServerData& First = bAscending ? A : B;
+	const FServerData& Second = bAscending ? B : A;
+
+	switch (SortKey)
+	{
+	case EServerSortKey::Score:
+		return GetScore(First) < GetScore(Second);
+	case EServerSortKey::Fill:
+		return GetFillRatio(First) < GetFillRatio(Second);
+	case EServerSortKey::Ping:
+		return First.PingInMs < Second.PingInMs;
+	case EServerSortKey::Host:
+		return First.HostUserName.Compare(Second.HostUserName, ESearchCase::IgnoreCase) < 0;
+	case EServerSortKey::Name:
+	default:
+		return First.Name.Compare(Second.Name, ESearchCase::IgnoreCase) < 0;
+	}
+}
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ServerData.h"
+
+enum class EServerSortKey : uint8
+{
+	// Lowest latency plus fill penalty first
+	Score,
+	Name,
+	Fill,
+	Ping,
+	Host,
+};
+
+/**
+ * Search results with the current filter and sort applied. Knows nothing about widgets.
+ */
+class UDEMYPROJECT_API FServerListModel
+{
+public:
+	void SetEntries(const TArray<FServerData>& InEntries);
+
+	/**
+	 * Replaces the entry with the same session id. Returns false if the session is not in the list.
+	 * The view is not rebuilt, call RebuildView() once after a batch of updates.
+	 */
+	bool UpdateEntry(const FServerData& Entry);
+
+	void SetFilter(const FString& InFilter);
+
+	/** Sorting by the current key again flips the direction */
+	void SetSortKey(EServerSortKey InSortKey);
+
+	const TArray<FServerData>& GetEntries() const { return Entries; }
+
+	/** Indices into GetEntries() that pass the filter, in sort order */
+	const TArray<int32>& GetView() const { return View; }
+
+	void RebuildView();
+
+	/** Lower is better: ping plus a penalty for empty sessions, full sessions last */
+	static float GetScore(const FServerData& Entry);
+
+private:
+	bool PassesFilter(const FServerData& Entry) const;
+	bool IsBefore(const FServerData& A, const FServerData& B) const;
+
+	TArray<FServerData> Entries;
+	TArray<int32> View;
+
+	// Index into Entries by session id, ping results arrive one session at a time
+	TMap<FString, int32> EntryIndexBySessionId;
+
+	FString Filter;
+	EServerSortKey SortKey = EServerSortKey::Score;
+	bool bAscending = true;
+};
@@ -4,18 +4,88 @@
 #include "ServerRow.h"
 
 #include "Components/Button.h"
+#include "Components/ListView.h"
+#include "Components/TextBlock.h"
 
-#include "MainMenu.h"
+#include "ServerListItem.h"
 
-void UServerRow::Setup(class UMainMenu* InParent, uint32 InIndex)
+bool UServerRow::Initialize()
 {
-	Parent = InParent;
-	Index = InIndex;
+	bool Success = Super::Initialize();
+
+	if (!Success)
+		return false;
+
+	if (!ensure(RowButton != nullptr))
+		return false;
+
+	// Bound once here, the list view recycles entry widgets across items
 	RowButton->OnClicked.AddDynamic(this, &UServerRow::OnClicked);
+
+	return true;
+}
+
+void UServerRow::SetServerData(const FServerData& Data)
+{
+	if (!ServerData.IsSet() || ServerData->Name != Data.Name)
+		ServerName->SetText(FText::FromString(Data.Name));
+
+	if (!ServerData.IsSet() || ServerData->HostUserName != Data.HostUserName)
+		HostUser->SetText(FText::FromString(Data.HostUserName));
+
+	if (!ServerData.IsSet() || ServerData->CurrentPlayers != Data.CurrentPlayers || ServerData->MaxPlayers != Data.MaxPlayers)
+	{
+		FString FractionText = FString::Printf(TEXT("%d/%d"), Data.CurrentPlayers, Data.MaxPlayers);
+		ConnectionFraction->SetText(FText::FromString(FractionText));
+	}
+
+	ServerData = Data;
+}
+
+void UServerRow::NativeOnListItemObjectSet(UObject* ListItemObject)
+{
+	IUserObjectListEntry::NativeOnListItemObjectSet(ListItemObject);
+
+	BindItem(Cast<UServerListItem>(ListItemObject));
+	OnItemDataChanged();
+}
+
+void UServerRow::NativeOnEntryReleased()
+{
+	IUserObjectListEntry::NativeOnEntryReleased();
+
+	BindItem(nullptr);
+}
+
+void UServerRow::BindItem(UServerListItem* Item)
+{
+	if (UServerListItem* PreviousItem = BoundItem.Get())
+		PreviousItem->OnDataChanged.Remove(DataChangedHandle);
+
+	BoundItem = Item;
+
+	if (Item != nullptr)
+		DataChangedHandle = Item->OnDataChanged.AddUObject(this, &UServerRow::OnItemDataChanged);
+}
+
+void UServerRow::OnItemDataChanged()
+{
+	if (const UServerListItem* Item = BoundItem.Get())
+		SetServerData(Item->GetData());
+}
+
+void UServerRow::NativeOnItemSelectionChanged(bool bIsSelected)
+{
+	IUserObjectListEntry::NativeOnItemSelectionChanged(bIsSelected);
+
+	Selected = bIsSelected;
 }
 
 void UServerRow::OnClicked()
 {
-	Parent->SelectIndex(Index);
+	UListView* OwningList = Cast<UListView>(UUserListEntryLibrary::GetOwningListView(this));
+
+	if (OwningList != nullptr)
+		OwningList->SetSelectedItem(GetListItem());
 
 }
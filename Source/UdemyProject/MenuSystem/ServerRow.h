@@ -4,13 +4,15 @@
 
 #include "CoreMinimal.h"
 #include "Blueprint/UserWidget.h"
+#include "Blueprint/IUserObjectListEntry.h"
+#include "ServerData.h"
 #include "ServerRow.generated.h"
 
 /**
  * 
  */
 UCLASS()
-class UDEMYPROJECT_API UServerRow : public UUserWidget
+class UDEMYPROJECT_API UServerRow : public UUserWidget, public IUserObjectListEntry
 {
 	GENERATED_BODY()
 	
@@ -27,13 +29,26 @@ public:
 	UPROPERTY(BlueprintReadOnly)
 	bool Selected = false;
 
-	void Setup(class UMainMenu* InParent, uint32 InIndex);
+	/** Updates the texts only for the fields that changed since the last call */
+	void SetServerData(const FServerData& Data);
+
+protected:
+	virtual bool Initialize();
+
+	// IUserObjectListEntry
+	virtual void NativeOnListItemObjectSet(UObject* ListItemObject) override;
+	virtual void NativeOnItemSelectionChanged(bool bIsSelected) override;
+	virtual void NativeOnEntryReleased() override;
 
 private:
-	UPROPERTY()
-	class UMainMenu* Parent;
+	TOptional<FServerData> ServerData;
+
+	// Item shown by this entry, its data changes are applied without regenerating the entry
+	TWeakObjectPtr<class UServerListItem> BoundItem;
+	FDelegateHandle DataChangedHandle;
 
-	uint32 Index;
+	void BindItem(class UServerListItem* Item);
+	void OnItemDataChanged();
 
 	UPROPERTY(Meta = (BindWidget))
 	class UButton* RowButton;
@@ -3,53 +3,83 @@
 
 #include "MovingPlatform.h"
 
+#include "Net/UnrealNetwork.h"
+
+#include "NetStatsSubsystem.h"
+#include "PlatformSimulationSubsystem.h"
+
 AMovingPlatform::AMovingPlatform()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bCanEverTick = false;
 
 	SetMobility(EComponentMobility::Movable);
+
+	// Clients evaluate the position from Path and Motion, so the transform is never replicated
+	bReplicates = true;
+	SetReplicatingMovement(false);
+	NetUpdateFrequency = 1.0f;
 }
 
 void AMovingPlatform::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// Clients start from the placed level data until the replicated path arrives
+	Path.Points.Reset(Waypoints.Num() + 2);
+	Path.Points.Add(GetActorLocation());
+	for (const FVector& Waypoint : Waypoints) {
+		Path.Points.Add(GetTransform().TransformPosition(Waypoint));
+	}
+	Path.Points.Add(GetTransform().TransformPosition(TargetLocation));
+	Path.bSmooth = bSmoothPath;
+	Path.EaseExponent = EaseExponent;
+
+	UPlatformSimulationSubsystem* Simulation = GetSimulation();
+	if (!ensure(Simulation != nullptr))
+		return;
+
 	if (HasAuthority()) {
-		SetReplicates(true);
-		SetReplicateMovement(true);
+		Motion.Speed = Speed;
+		Motion.PhaseDistance = 0.0f;
+		Motion.PhaseServerTime = Simulation->GetServerTime();
+		Motion.bActive = ActiveTrigger > 0;
+	}
+
+	SimulationIndex = Simulation->AddPlatform(this, Path, Motion);
+}
+
+void AMovingPlatform::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UPlatformSimulationSubsystem* Simulation = GetSimulation();
+	if (Simulation != nullptr && SimulationIndex != INDEX_NONE) {
+		Simulation->RemovePlatform(SimulationIndex);
+		SimulationIndex = INDEX_NONE;
 	}
-	
-	GlobalStartLocation = GetActorLocation();
-	GlobalTargetLocation = GetTransform().TransformPosition(TargetLocation);
+
+	Super::EndPlay(EndPlayReason);
 }
 
-void AMovingPlatform::Tick(float DeltaTime)
+void AMovingPlatform::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
-	Super::Tick(DeltaTime);
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	if (ActiveTrigger > 0) {
-		if (HasAuthority()) {
-			FVector Location = GetActorLocation();
-			float JourneyLength = (GlobalTargetLocation - GlobalStartLocation).Size();
-			float JourneyTravelled = (Location - GlobalStartLocation).Size();
-
-			if (JourneyTravelled >= JourneyLength) {
-				FVector Swap = GlobalStartLocation;
-				GlobalStartLocation = GlobalTargetLocation;
-				GlobalTargetLocation = Swap;
-			}
-			// ȭ ͸ Ŵ
-			FVector Direction = (GlobalTargetLocation - GlobalStartLocation).GetSafeNormal();
-			Location += Speed * DeltaTime * Direction;
-
-			SetActorLocation(Location);
-		}
-	}
+	DOREPLIFETIME_CONDITION(AMovingPlatform, Path, COND_InitialOnly);
+	DOREPLIFETIME(AMovingPlatform, Motion);
+}
+
+void AMovingPlatform::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	if (UNetStatsSubsystem* NetStats = GetWorld()->GetSubsystem<UNetStatsSubsystem>())
+		NetStats->RecordReplication(this);
 }
 
 void AMovingPlatform::AddActiveTrigger()
 {
 	ActiveTrigger++;
+
+	UpdateMotionActive();
 }
 
 void AMovingPlatform::RemoveActiveTrigger()
@@ -57,4 +87,96 @@ void AMovingPlatform::RemoveActiveTrigger()
 	if (ActiveTrigger > 0) {
 		ActiveTrigger--;
 	}
+
+	UpdateMotionActive();
+}
+
+void AMovingPlatform::OnRep_Path()
+{
+	if (UNetStatsSubsystem* NetStats = GetWorld()->GetSubsystem<UNetStatsSubsystem>())
+		NetStats->RecordPropertyUpdate(this);
+
+	UPlatformSimulationSubsystem* Simulation = GetSimulation();
+	if (Simulation != nullptr && SimulationIndex != INDEX_NONE) {
+		Simulation->SetPath(SimulationIndex, Path);
+	}
+
+	SnapToSimulatedLocation();
+}
+
+void AMovingPlatform::OnRep_Motion()
+{
+	if (UNetStatsSubsystem* NetStats = GetWorld()->GetSubsystem<UNetStatsSubsystem>())
+		NetStats->RecordPropertyUpdate(this);
+
+	UPlatformSimulationSubsystem* Simulation = GetSimulation();
+	if (Simulation != nullptr && SimulationIndex != INDEX_NONE) {
+		Simulation->SetMotion(SimulationIndex, Motion);
+	}
+
+	SnapToSimulatedLocation();
+}
+
+float AMovingPlatform::GetPhaseDistance() const
+{
+	UPlatformSimulationSubsystem* Simulation = GetSimulation();
+	if (Simulation == nullptr || SimulationIndex == INDEX_NONE)
+		return Motion.PhaseDistance;
+
+	return Simulation->GetDistance(SimulationIndex, Simulation->GetServerTime());
+}
+
+void AMovingPlatform::SetPhaseDistance(float Distance)
+{
+	if (!HasAuthority())
+		return;
+
+	UPlatformSimulationSubsystem* Simulation = GetSimulation();
+	if (Simulation == nullptr || SimulationIndex == INDEX_NONE)
+		return;
+
+	Motion.PhaseDistance = Distance;
+	Motion.PhaseServerTime = Simulation->GetServerTime();
+
+	Simulation->SetMotion(SimulationIndex, Motion);
+	SnapToSimulatedLocation();
+	ForceNetUpdate();
+}
+
+UPlatformSimulationSubsystem* AMovingPlatform::GetSimulation() const
+{
+	UWorld* World = GetWorld();
+	return World != nullptr ? World->GetSubsystem<UPlatformSimulationSubsystem>() : nullptr;
+}
+
+void AMovingPlatform::UpdateMotionActive()
+{
+	if (!HasAuthority())
+		return;
+
+	const bool bActive = ActiveTrigger > 0;
+	if (bActive == Motion.bActive)
+		return;
+
+	UPlatformSimulationSubsystem* Simulation = GetSimulation();
+	if (Simulation == nullptr || SimulationIndex == INDEX_NONE)
+		return;
+
+	// Freeze the phase where the platform is now and restart the clock from here
+	const double Now = Simulation->GetServerTime();
+	Motion.PhaseDistance = Simulation->GetDistance(SimulationIndex, Now);
+	Motion.PhaseServerTime = Now;
+	Motion.bActive = bActive;
+
+	Simulation->SetMotion(SimulationIndex, Motion);
+	ForceNetUpdate();
+}
+
+void AMovingPlatform::SnapToSimulatedLocation()
+{
+	UPlatformSimulationSubsystem* Simulation = GetSimulation();
+	if (Simulation == nullptr || SimulationIndex == INDEX_NONE)
+		return;
+
+	SetActorLocation(Simulation->GetLocation(SimulationIndex, Simulation->GetServerTime()));
 }
@@ -4,22 +4,70 @@
 
 #include "CoreMinimal.h"
 #include "Engine/StaticMeshActor.h"
+#include "Engine/NetSerialization.h"
 #include "MovingPlatform.generated.h"
 
+/** Path control points in world space. Only sent once when the platform becomes relevant. */
+USTRUCT()
+struct FMovingPlatformPath
+{
+	GENERATED_BODY()
+
+	// Start, waypoints, then target
+	UPROPERTY()
+	TArray<FVector_NetQuantize> Points;
+
+	// Catmull-Rom through the points instead of straight segments
+	UPROPERTY()
+	bool bSmooth = false;
+
+	// 1 moves at constant speed, higher values ease in and out at both ends of the path
+	UPROPERTY()
+	float EaseExponent = 1.0f;
+};
+
+/**
+ * Phase of the ping-pong motion. Only changes when the platform is activated or stopped,
+ * so a platform moving steadily replicates nothing.
+ */
+USTRUCT()
+struct FMovingPlatformMotion
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	float Speed = 0.0f;
+
+	// Distance travelled along the start -> target -> start cycle at PhaseServerTime
+	UPROPERTY()
+	float PhaseDistance = 0.0f;
+
+	// Server world time of the last phase change
+	UPROPERTY()
+	double PhaseServerTime = 0.0;
+
+	UPROPERTY()
+	bool bActive = false;
+};
+
 /**
- * 
+ * Moved by UPlatformSimulationSubsystem; the actor itself does not tick.
  */
 UCLASS()
 class UDEMYPROJECT_API AMovingPlatform : public AStaticMeshActor
 {
 	GENERATED_BODY()
-	
+
 public:
 	AMovingPlatform();
 
 	virtual void BeginPlay() override;
 
-	virtual void Tick(float DeltaTime) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
 
 	UPROPERTY(EditAnywhere, Category = "Moving")
 	float Speed = 20;
@@ -27,13 +75,48 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Moving", Meta = (MakeEditWidget = true))
 	FVector TargetLocation;
 
+	/** Visited in order between the start and TargetLocation */
+	UPROPERTY(EditAnywhere, Category = "Moving", Meta = (MakeEditWidget = true))
+	TArray<FVector> Waypoints;
+
+	UPROPERTY(EditAnywhere, Category = "Moving")
+	bool bSmoothPath = false;
+
+	UPROPERTY(EditAnywhere, Category = "Moving", Meta = (ClampMin = 1.0))
+	float EaseExponent = 1.0f;
+
 	void AddActiveTrigger();
 	void RemoveActiveTrigger();
 
+	/** Distance travelled along the start -> target -> start cycle right now */
+	float GetPhaseDistance() const;
+
+	/** Server only. Moves the platform to a point of its cycle, e.g. the one a migrated host left it at. */
+	void SetPhaseDistance(float Distance);
+
 private:
-	FVector GlobalTargetLocation;
-	FVector GlobalStartLocation;
+	friend class UPlatformSimulationSubsystem;
 
 	UPROPERTY(EditAnywhere)
 	int8 ActiveTrigger = 1;
+
+	UPROPERTY(ReplicatedUsing = OnRep_Path)
+	FMovingPlatformPath Path;
+
+	UPROPERTY(ReplicatedUsing = OnRep_Motion)
+	FMovingPlatformMotion Motion;
+
+	UFUNCTION()
+	void OnRep_Path();
+
+	UFUNCTION()
+	void OnRep_Motion();
+
+	// Slot in UPlatformSimulationSubsystem, INDEX_NONE while not simulated
+	int32 SimulationIndex = INDEX_NONE;
+
+	class UPlatformSimulationSubsystem* GetSimulation() const;
+
+	void UpdateMotionActive();
+	void SnapToSimulatedLocation();
 };
@@ -0,0 +1,185 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NetStatsSubsystem.h"
+
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+CSV_DEFINE_CATEGORY(UdemyNet, true);
+
+namespace
+{
+	TAutoConsoleVariable<bool> CVarNetStatsEnable(
+		TEXT("udemy.NetStats.Enable"),
+		true,
+		TEXT("Count replication, property updates and RPCs per actor class and sample connection stats."));
+
+	TAutoConsoleVariable<float> CVarNetStatsInterval(
+		TEXT("udemy.NetStats.Interval"),
+		1.0f,
+		TEXT("Seconds between two network stat samples."));
+
+	FAutoConsoleCommandWithWorld NetStatsCommand(
+		TEXT("udemy.NetStats"),
+		TEXT("Prints bytes, loss and RTT per connection and replication counts per actor class."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			const UNetStatsSubsystem* NetStats = World != nullptr ? World->GetSubsystem<UNetStatsSubsystem>() : nullptr;
+			if (NetStats != nullptr)
+				NetStats->PrintStats();
+		}));
+
+#if CSV_PROFILER
+	void RecordCsvStat(const FString& Name, float Value)
+	{
+		FCsvProfiler::RecordCustomStat(*Name, CSV_CATEGORY_INDEX(UdemyNet), Value, ECsvCustomStatOp::Set);
+	}
+#endif
+}
+
+void UNetStatsSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	TimeSinceSample += DeltaTime;
+	if (TimeSinceSample < CVarNetStatsInterval.GetValueOnGameThread())
+		return;
+
+	LastSampleDuration = TimeSinceSample;
+	TimeSinceSample = 0.0f;
+
+	Sample();
+}
+
+bool UNetStatsSubsystem::IsTickable() const
+{
+	const UWorld* World = GetWorld();
+	return CVarNetStatsEnable.GetValueOnGameThread() && World != nullptr && World->GetNetDriver() != nullptr;
+}
+
+TStatId UNetStatsSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UNetStatsSubsystem, STATGROUP_Tickables);
+}
+
+UNetStatsSubsystem::FClassCounters* UNetStatsSubsystem::FindCounters(const AActor* Actor)
+{
+	if (Actor == nullptr || !CVarNetStatsEnable.GetValueOnGameThread())
+		return nullptr;
+
+	return &ClassCounters.FindOrAdd(Actor->GetClass()->GetFName());
+}
+
+void UNetStatsSubsystem::RecordReplication(const AActor* Actor)
+{
+	if (FClassCounters* Counters = FindCounters(Actor))
+		++Counters->Replications;
+}
+
+void UNetStatsSubsystem::RecordPropertyUpdate(const AActor* Actor)
+{
+	if (FClassCounters* Counters = FindCounters(Actor))
+		++Counters->PropertyUpdates;
+}
+
+void UNetStatsSubsystem::RecordRpc(const AActor* Actor)
+{
+	if (FClassCounters* Counters = FindCounters(Actor))
+		++Counters->Rpcs;
+}
+
+void UNetStatsSubsystem::Sample()
+{
+	LastConnections.Reset();
+
+	UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+
+	TArray<UNetConnection*> Connections;
+	if (NetDriver->ServerConnection != nullptr)
+		Connections.Add(NetDriver->ServerConnection);
+	Connections.Append(NetDriver->ClientConnections);
+
+	for (UNetConnection* Connection : Connections)
+	{
+		if (Connection == nullptr)
+			continue;
+
+		FConnectionSample& ConnectionSample = LastConnections.AddDefaulted_GetRef();
+		ConnectionSample.Name = Connection->LowLevelGetRemoteAddress(true);
+		ConnectionSample.InBytesPerSecond = Connection->InBytesPerSecond;
+		ConnectionSample.OutBytesPerSecond = Connection->OutBytesPerSecond;
+		ConnectionSample.InLoss = Connection->GetInLossPercentage().GetAvgLossPercentage() * 100.0f;
+		ConnectionSample.OutLoss = Connection->GetOutLossPercentage().GetAvgLossPercentage() * 100.0f;
+		ConnectionSample.RttMs = Connection->AvgLag * 1000.0f;
+	}
+
+	// Rates per second, so samples of different intervals compare
+	const float Scale = LastSampleDuration > 0.0f ? 1.0f / LastSampleDuration : 0.0f;
+
+	LastClassCounters.Reset();
+	for (const TPair<FName, FClassCounters>& Pair : ClassCounters)
+	{
+		FClassCounters& Rates = LastClassCounters.Add(Pair.Key);
+		Rates.Replications = FMath::RoundToInt(Pair.Value.Replications * Scale);
+		Rates.PropertyUpdates = FMath::RoundToInt(Pair.Value.PropertyUpdates * Scale);
+		Rates.Rpcs = FMath::RoundToInt(Pair.Value.Rpcs * Scale);
+	}
+	ClassCounters.Reset();
+
+#if CSV_PROFILER
+	if (FCsvProfiler::Get()->IsCapturing())
+	{
+		int32 MaxOutBytes = 0;
+		float MaxLoss = 0.0f;
+		float MaxRtt = 0.0f;
+		int64 TotalOutBytes = 0;
+		int64 TotalInBytes = 0;
+
+		for (const FConnectionSample& ConnectionSample : LastConnections)
+		{
+			TotalInBytes += ConnectionSample.InBytesPerSecond;
+			TotalOutBytes += ConnectionSample.OutBytesPerSecond;
+			MaxOutBytes = FMath::Max(MaxOutBytes, ConnectionSample.OutBytesPerSecond);
+			MaxLoss = FMath::Max3(MaxLoss, ConnectionSample.InLoss, ConnectionSample.OutLoss);
+			MaxRtt = FMath::Max(MaxRtt, ConnectionSample.RttMs);
+		}
+
+		RecordCsvStat(TEXT("Connections"), LastConnections.Num());
+		RecordCsvStat(TEXT("InBytesPerSec"), TotalInBytes);
+		RecordCsvStat(TEXT("OutBytesPerSec"), TotalOutBytes);
+		RecordCsvStat(TEXT("MaxConnectionOutBytesPerSec"), MaxOutBytes);
+		RecordCsvStat(TEXT("MaxLossPercent"), MaxLoss);
+		RecordCsvStat(TEXT("MaxRttMs"), MaxRtt);
+
+		for (const TPair<FName, FClassCounters>& Pair : LastClassCounters)
+		{
+			const FString ClassName = Pair.Key.ToString();
+			RecordCsvStat(ClassName + TEXT("_Replications"), Pair.Value.Replications);
+			RecordCsvStat(ClassName + TEXT("_PropertyUpdates"), Pair.Value.PropertyUpdates);
+			RecordCsvStat(ClassName + TEXT("_Rpcs"), Pair.Value.Rpcs);
+		}
+	}
+#endif
+}
+
+void UNetStatsSubsystem::PrintStats() const
+{
+	UE_LOG(LogTemp, Display, TEXT("Net stats over %.1f s, %d connection(s)"), LastSampleDuration, LastConnections.Num());
+
+	for (const FConnectionSample& ConnectionSample : LastConnections)
+	{
+		UE_LOG(LogTemp, Display, TEXT("  %s: in %d B/s, out %d B/s, loss in %.1f%% out %.1f%%, RTT %.0f ms"),
+			*ConnectionSample.Name, ConnectionSample.InBytesPerSecond, ConnectionSample.OutBytesPerSecond, ConnectionSample.InLoss, ConnectionSample.OutLoss, ConnectionSample.RttMs);
+	}
+
+	for (const TPair<FName, FClassCounters>& Pair : LastClassCounters)
+	{
+		UE_LOG(LogTemp, Display, TEXT("  %s: %d replications/s, %d property updates/s, %d RPCs/s"),
+			*Pair.Key.ToString(), Pair.Value.Replications, Pair.Value.PropertyUpdates, Pair.Value.Rpcs);
+	}
+}
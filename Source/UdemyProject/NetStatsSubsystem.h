@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NetStatsSubsystem.generated.h"
+
+class AActor;
+class UNetConnection;
+
+/**
+ * Network cost per connection and per replicated actor class.
+ * Connection numbers (bytes, loss, RTT) are read from the net driver once per sample interval,
+ * class numbers are counted by the project's replicated actors through the Record functions.
+ * Every sample is pushed to the UdemyNet CSV profiler category; "udemy.NetStats" prints the last one.
+ * Recording is a map increment, so it stays on in shipping builds unless udemy.NetStats.Enable is 0.
+ */
+UCLASS()
+class UDEMYPROJECT_API UNetStatsSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	/** Actor was considered for replication this frame (server) */
+	void RecordReplication(const AActor* Actor);
+
+	/** Replicated property of the actor was received (client) */
+	void RecordPropertyUpdate(const AActor* Actor);
+
+	/** RPC was sent on the actor */
+	void RecordRpc(const AActor* Actor);
+
+	void PrintStats() const;
+
+private:
+	struct FClassCounters
+	{
+		int32 Replications = 0;
+		int32 PropertyUpdates = 0;
+		int32 Rpcs = 0;
+	};
+
+	struct FConnectionSample
+	{
+		FString Name;
+		int32 InBytesPerSecond = 0;
+		int32 OutBytesPerSecond = 0;
+		float InLoss = 0.0f;
+		float OutLoss = 0.0f;
+		float RttMs = 0.0f;
+	};
+
+	FClassCounters* FindCounters(const AActor* Actor);
+
+	void Sample();
+
+	float TimeSinceSample = 0.0f;
+
+	// Counted since the last sample
+	TMap<FName, FClassCounters> ClassCounters;
+
+	// Per second rates of the last sample
+	float LastSampleDuration = 0.0f;
+	TMap<FName, FClassCounters> LastClassCounters;
+	TArray<FConnectionSample> LastConnections;
+};
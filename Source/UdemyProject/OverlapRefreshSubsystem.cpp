@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "OverlapRefreshSubsystem.h"
+
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/Character.h"
+
+#include "TickProfilerSubsystem.h"
+
+void UOverlapRefreshSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	UDEMY_TICK_PROFILER_SCOPE(this, Overlaps);
+
+	for (auto It = Characters.CreateIterator(); It; ++It)
+	{
+		ACharacter* Character = It.Key().Get();
+		if (Character == nullptr)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+		if (Capsule != nullptr)
+			Capsule->UpdateOverlaps();
+	}
+}
+
+bool UOverlapRefreshSubsystem::IsTickable() const
+{
+	return Characters.Num() > 0;
+}
+
+TStatId UOverlapRefreshSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UOverlapRefreshSubsystem, STATGROUP_Tickables);
+}
+
+void UOverlapRefreshSubsystem::AddCharacterNearTrigger(ACharacter* Character)
+{
+	if (Character == nullptr)
+		return;
+
+	++Characters.FindOrAdd(Character).NearTriggerCount;
+}
+
+void UOverlapRefreshSubsystem::RemoveCharacterNearTrigger(ACharacter* Character)
+{
+	FRefreshReason* Reason = Characters.Find(Character);
+	if (Reason == nullptr)
+		return;
+
+	Reason->NearTriggerCount = FMath::Max(Reason->NearTriggerCount - 1, 0);
+
+	if (!Reason->IsNeeded())
+		Characters.Remove(Character);
+}
+
+void UOverlapRefreshSubsystem::SetCharacterOnMovingPlatform(ACharacter* Character, bool bOnPlatform)
+{
+	if (Character == nullptr)
+		return;
+
+	if (bOnPlatform)
+	{
+		Characters.FindOrAdd(Character).bOnMovingPlatform = true;
+		return;
+	}
+
+	FRefreshReason* Reason = Characters.Find(Character);
+	if (Reason == nullptr)
+		return;
+
+	Reason->bOnMovingPlatform = false;
+
+	if (!Reason->IsNeeded())
+		Characters.Remove(Character);
+}
+
+void UOverlapRefreshSubsystem::RemoveCharacter(ACharacter* Character)
+{
+	Characters.Remove(Character);
+}
@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "OverlapRefreshSubsystem.generated.h"
+
+class ACharacter;
+
+/**
+ * Refreshes capsule overlaps only for characters that can actually change trigger state:
+ * those inside the proximity volume of an APlatformTrigger or standing on an AMovingPlatform.
+ * Nothing ticks while no character is registered.
+ */
+UCLASS()
+class UDEMYPROJECT_API UOverlapRefreshSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	void AddCharacterNearTrigger(ACharacter* Character);
+	void RemoveCharacterNearTrigger(ACharacter* Character);
+
+	void SetCharacterOnMovingPlatform(ACharacter* Character, bool bOnPlatform);
+
+	void RemoveCharacter(ACharacter* Character);
+
+private:
+	struct FRefreshReason
+	{
+		// A character can stand in the proximity of several triggers at once
+		int32 NearTriggerCount = 0;
+		bool bOnMovingPlatform = false;
+
+		bool IsNeeded() const { return NearTriggerCount > 0 || bOnMovingPlatform; }
+	};
+
+	TMap<TWeakObjectPtr<ACharacter>, FRefreshReason> Characters;
+};
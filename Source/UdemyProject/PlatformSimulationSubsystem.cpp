@@ -0,0 +1,305 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PlatformSimulationSubsystem.h"
+
+#include "GameFramework/GameStateBase.h"
+
+#include "MovingPlatform.h"
+#include "TickProfilerSubsystem.h"
+
+namespace
+{
+	// Dense steps per segment used to measure a smooth path before resampling it
+	constexpr int32 DenseStepsPerSegment = 16;
+	constexpr int32 SamplesPerSegment = 32;
+	constexpr int32 MaxSamples = 1024;
+
+	float WrapCycle(double Travelled, float Length)
+	{
+		const float CycleLength = 2.0f * Length;
+		if (CycleLength <= UE_KINDA_SMALL_NUMBER)
+			return 0.0f;
+
+		float Distance = (float)FMath::Fmod(Travelled, (double)CycleLength);
+		if (Distance < 0.0f)
+			Distance += CycleLength;
+
+		return Distance;
+	}
+
+	// Second half of the cycle is the way back
+	float PingPong(float Distance, float Length)
+	{
+		return Distance <= Length ? Distance : 2.0f * Length - Distance;
+	}
+
+	FVector CatmullRom(const FVector& P0, const FVector& P1, const FVector& P2, const FVector& P3, float T)
+	{
+		const float T2 = T * T;
+		const float T3 = T2 * T;
+
+		return 0.5f * ((2.0f * P1)
+			+ (P2 - P0) * T
+			+ (2.0f * P0 - 5.0f * P1 + 4.0f * P2 - P3) * T2
+			+ (3.0f * P1 - P0 - 3.0f * P2 + P3) * T3);
+	}
+
+	/** Resamples the path into points spaced evenly by arc length. All square roots of the path are paid here. */
+	void BuildArcLengthTable(const FMovingPlatformPath& Path, TArray<FVector>& OutSamples, float& OutLength)
+	{
+		const TArray<FVector_NetQuantize>& Points = Path.Points;
+
+		OutSamples.Reset();
+		OutLength = 0.0f;
+
+		if (Points.Num() < 2)
+		{
+			const FVector Point = Points.Num() > 0 ? FVector(Points[0]) : FVector::ZeroVector;
+			OutSamples.Add(Point);
+			OutSamples.Add(Point);
+			return;
+		}
+
+		const int32 LastPoint = Points.Num() - 1;
+
+		// A single straight segment is exact with its two end points
+		if (!Path.bSmooth && LastPoint == 1)
+		{
+			OutSamples.Add(Points[0]);
+			OutSamples.Add(Points[1]);
+			OutLength = FVector::Dist(Points[0], Points[1]);
+			return;
+		}
+
+		const int32 Steps = Path.bSmooth ? DenseStepsPerSegment : 1;
+
+		TArray<FVector> Dense;
+		TArray<float> DenseDistances;
+		Dense.Reserve(LastPoint * Steps + 1);
+		DenseDistances.Reserve(LastPoint * Steps + 1);
+
+		Dense.Add(Points[0]);
+		DenseDistances.Add(0.0f);
+
+		for (int32 Segment = 0; Segment < LastPoint; ++Segment)
+		{
+			const FVector P0 = Points[FMath::Max(Segment - 1, 0)];
+			const FVector P1 = Points[Segment];
+			const FVector P2 = Points[Segment + 1];
+			const FVector P3 = Points[FMath::Min(Segment + 2, LastPoint)];
+
+			for (int32 Step = 1; Step <= Steps; ++Step)
+			{
+				const float T = (float)Step / Steps;
+				const FVector Point = Path.bSmooth ? CatmullRom(P0, P1, P2, P3, T) : FMath::Lerp(P1, P2, T);
+
+				DenseDistances.Add(DenseDistances.Last() + FVector::Dist(Dense.Last(), Point));
+				Dense.Add(Point);
+			}
+		}
+
+		OutLength = DenseDistances.Last();
+
+		const int32 Count = FMath::Clamp(LastPoint * SamplesPerSegment + 1, 2, MaxSamples);
+		const float Step = OutLength / (Count - 1);
+
+		OutSamples.Reserve(Count);
+
+		int32 DenseIndex = 0;
+		for (int32 i = 0; i < Count; ++i)
+		{
+			const float Target = i * Step;
+
+			while (DenseIndex < Dense.Num() - 2 && DenseDistances[DenseIndex + 1] < Target)
+				++DenseIndex;
+
+			const float SegmentLength = DenseDistances[DenseIndex + 1] - DenseDistances[DenseIndex];
+			const float Alpha = SegmentLength > UE_KINDA_SMALL_NUMBER ? (Target - DenseDistances[DenseIndex]) / SegmentLength : 0.0f;
+
+			OutSamples.Add(FMath::Lerp(Dense[DenseIndex], Dense[DenseIndex + 1], FMath::Clamp(Alpha, 0.0f, 1.0f)));
+		}
+	}
+}
+
+void UPlatformSimulationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const int32 Count = Platforms.Num();
+	if (Count == 0)
+		return;
+
+	UDEMY_TICK_PROFILER_SCOPE(this, Platforms);
+
+	const double Now = GetServerTime();
+
+	PathDistances.SetNumUninitialized(Count, false);
+
+	// Branch-free over every slot; inactive platforms keep their frozen phase through the Active mask
+	for (int32 i = 0; i < Count; ++i)
+	{
+		const double Travelled = PhaseDistances[i] + Active[i] * Speeds[i] * (Now - PhaseServerTimes[i]);
+		PathDistances[i] = PingPong(WrapCycle(Travelled, Lengths[i]), Lengths[i]);
+	}
+
+	for (int32 i = 0; i < Count; ++i)
+	{
+		if (Active[i] != 0 && Platforms[i] != nullptr)
+			Platforms[i]->SetActorLocation(EvaluatePath(i, PathDistances[i]));
+	}
+}
+
+bool UPlatformSimulationSubsystem::IsTickable() const
+{
+	return NumActive > 0;
+}
+
+TStatId UPlatformSimulationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPlatformSimulationSubsystem, STATGROUP_Tickables);
+}
+
+int32 UPlatformSimulationSubsystem::AddPlatform(AMovingPlatform* Platform, const FMovingPlatformPath& Path, const FMovingPlatformMotion& Motion)
+{
+	const int32 Index = Platforms.Add(Platform);
+
+	SampleOffsets.AddZeroed();
+	SampleCounts.AddZeroed();
+	InvSampleSteps.AddZeroed();
+	Lengths.AddZeroed();
+	EaseExponents.AddZeroed();
+	Speeds.AddZeroed();
+	PhaseDistances.AddZeroed();
+	PhaseServerTimes.AddZeroed();
+	Active.AddZeroed();
+
+	SetPath(Index, Path);
+	SetMotion(Index, Motion);
+
+	return Index;
+}
+
+void UPlatformSimulationSubsystem::RemovePlatform(int32 Index)
+{
+	if (!Platforms.IsValidIndex(Index))
+		return;
+
+	ReleaseSamples(Index);
+
+	NumActive -= Active[Index];
+
+	Platforms.RemoveAtSwap(Index, 1, false);
+	SampleOffsets.RemoveAtSwap(Index, 1, false);
+	SampleCounts.RemoveAtSwap(Index, 1, false);
+	InvSampleSteps.RemoveAtSwap(Index, 1, false);
+	Lengths.RemoveAtSwap(Index, 1, false);
+	EaseExponents.RemoveAtSwap(Index, 1, false);
+	Speeds.RemoveAtSwap(Index, 1, false);
+	PhaseDistances.RemoveAtSwap(Index, 1, false);
+	PhaseServerTimes.RemoveAtSwap(Index, 1, false);
+	Active.RemoveAtSwap(Index, 1, false);
+
+	// The last platform moved into the freed slot
+	if (Platforms.IsValidIndex(Index) && Platforms[Index] != nullptr)
+		Platforms[Index]->SimulationIndex = Index;
+}
+
+void UPlatformSimulationSubsystem::SetPath(int32 Index, const FMovingPlatformPath& Path)
+{
+	if (!Platforms.IsValidIndex(Index))
+		return;
+
+	TArray<FVector> PathSamples;
+	float Length = 0.0f;
+	BuildArcLengthTable(Path, PathSamples, Length);
+
+	ReleaseSamples(Index);
+
+	SampleOffsets[Index] = Samples.Num();
+	SampleCounts[Index] = PathSamples.Num();
+	Samples.Append(PathSamples);
+
+	Lengths[Index] = Length;
+	InvSampleSteps[Index] = Length > UE_KINDA_SMALL_NUMBER ? (PathSamples.Num() - 1) / Length : 0.0f;
+	EaseExponents[Index] = FMath::Max(Path.EaseExponent, 1.0f);
+}
+
+void UPlatformSimulationSubsystem::SetMotion(int32 Index, const FMovingPlatformMotion& Motion)
+{
+	if (!Platforms.IsValidIndex(Index))
+		return;
+
+	Speeds[Index] = Motion.Speed;
+	PhaseDistances[Index] = Motion.PhaseDistance;
+	PhaseServerTimes[Index] = Motion.PhaseServerTime;
+	const uint8 bActive = Motion.bActive ? 1 : 0;
+	NumActive += bActive - Active[Index];
+	Active[Index] = bActive;
+}
+
+float UPlatformSimulationSubsystem::GetDistance(int32 Index, double ServerTime) const
+{
+	if (!Platforms.IsValidIndex(Index))
+		return 0.0f;
+
+	const double Travelled = PhaseDistances[Index] + Active[Index] * Speeds[Index] * (ServerTime - PhaseServerTimes[Index]);
+	return WrapCycle(Travelled, Lengths[Index]);
+}
+
+FVector UPlatformSimulationSubsystem::GetLocation(int32 Index, double ServerTime) const
+{
+	if (!Platforms.IsValidIndex(Index))
+		return FVector::ZeroVector;
+
+	return EvaluatePath(Index, PingPong(GetDistance(Index, ServerTime), Lengths[Index]));
+}
+
+double UPlatformSimulationSubsystem::GetServerTime() const
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr)
+		return 0.0;
+
+	AGameStateBase* GameState = World->GetGameState();
+	if (GameState != nullptr)
+		return GameState->GetServerWorldTimeSeconds();
+
+	return World->GetTimeSeconds();
+}
+
+FVector UPlatformSimulationSubsystem::EvaluatePath(int32 Index, float Distance) const
+{
+	const float Length = Lengths[Index];
+
+	float ArcLength = Distance;
+	if (EaseExponents[Index] > 1.0f && Length > UE_KINDA_SMALL_NUMBER)
+		ArcLength = FMath::InterpEaseInOut(0.0f, Length, Distance / Length, EaseExponents[Index]);
+
+	const int32 Offset = SampleOffsets[Index];
+	const int32 Count = SampleCounts[Index];
+
+	const float Sample = FMath::Clamp(ArcLength * InvSampleSteps[Index], 0.0f, (float)(Count - 1));
+	const int32 SampleIndex = FMath::Min((int32)Sample, Count - 2);
+
+	return FMath::Lerp(Samples[Offset + SampleIndex], Samples[Offset + SampleIndex + 1], Sample - SampleIndex);
+}
+
+void UPlatformSimulationSubsystem::ReleaseSamples(int32 Index)
+{
+	const int32 Offset = SampleOffsets[Index];
+	const int32 Count = SampleCounts[Index];
+
+	if (Count == 0)
+		return;
+
+	Samples.RemoveAt(Offset, Count, false);
+
+	for (int32& OtherOffset : SampleOffsets)
+	{
+		if (OtherOffset > Offset)
+			OtherOffset -= Count;
+	}
+
+	SampleCounts[Index] = 0;
+}
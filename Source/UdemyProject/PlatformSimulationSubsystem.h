@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PlatformSimulationSubsystem.generated.h"
+
+class AMovingPlatform;
+struct FMovingPlatformPath;
+struct FMovingPlatformMotion;
+
+/**
+ * Moves every AMovingPlatform of the world in one pass.
+ * Platform data is kept as parallel arrays indexed by the platform's simulation index,
+ * so the per-frame update walks contiguous memory instead of dispatching one actor tick per platform.
+ *
+ * Each path is resampled into points spaced evenly by arc length when it is set,
+ * so evaluating a location is a table lookup and a lerp with no square root.
+ * Nothing ticks while every platform is stopped.
+ */
+UCLASS()
+class UDEMYPROJECT_API UPlatformSimulationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	int32 AddPlatform(AMovingPlatform* Platform, const FMovingPlatformPath& Path, const FMovingPlatformMotion& Motion);
+	void RemovePlatform(int32 Index);
+
+	void SetPath(int32 Index, const FMovingPlatformPath& Path);
+	void SetMotion(int32 Index, const FMovingPlatformMotion& Motion);
+
+	/** Distance travelled along the start -> target -> start cycle */
+	float GetDistance(int32 Index, double ServerTime) const;
+	FVector GetLocation(int32 Index, double ServerTime) const;
+
+	double GetServerTime() const;
+
+	int32 Num() const { return Platforms.Num(); }
+
+private:
+	FVector EvaluatePath(int32 Index, float Distance) const;
+
+	void ReleaseSamples(int32 Index);
+
+	UPROPERTY()
+	TArray<AMovingPlatform*> Platforms;
+
+	// Arc-length table of a platform is Samples[SampleOffsets[i] .. SampleOffsets[i] + SampleCounts[i])
+	TArray<int32> SampleOffsets;
+	TArray<int32> SampleCounts;
+	TArray<float> InvSampleSteps;
+	TArray<float> Lengths;
+	TArray<float> EaseExponents;
+	TArray<float> Speeds;
+	TArray<float> PhaseDistances;
+	TArray<double> PhaseServerTimes;
+	TArray<uint8> Active;
+
+	// The subsystem sleeps while no platform is active
+	int32 NumActive = 0;
+
+	TArray<FVector> Samples;
+
+	// Scratch output of the batched pass, reused every frame
+	TArray<float> PathDistances;
+};
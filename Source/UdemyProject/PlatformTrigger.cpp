@@ -4,13 +4,19 @@
 #include "PlatformTrigger.h"
 
 #include "Components/BoxComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/Character.h"
 #include "MovingPlatform.h"
+#include "OverlapRefreshSubsystem.h"
+#include "TickProfilerSubsystem.h"
 
 // Sets default values
 APlatformTrigger::APlatformTrigger()
 {
-	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	// State changes are driven by overlap events, so the trigger never ticks
+	PrimaryActorTick.bCanEverTick = false;
+
+	TriggeringActorClass = APawn::StaticClass();
 
 	TriggerVolume = CreateDefaultSubobject<UBoxComponent>(TEXT("TriggerVolume"));
 
@@ -19,6 +25,14 @@ APlatformTrigger::APlatformTrigger()
 
 	TriggerVolume->OnComponentBeginOverlap.AddDynamic(this, &APlatformTrigger::OnOverlapBegin);
 	TriggerVolume->OnComponentEndOverlap.AddDynamic(this, &APlatformTrigger::OnOverlapEnd);
+
+	ProximityVolume = CreateDefaultSubobject<UBoxComponent>(TEXT("ProximityVolume"));
+	ProximityVolume->SetupAttachment(TriggerVolume);
+	ProximityVolume->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+	ProximityVolume->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Overlap);
+
+	ProximityVolume->OnComponentBeginOverlap.AddDynamic(this, &APlatformTrigger::OnProximityBegin);
+	ProximityVolume->OnComponentEndOverlap.AddDynamic(this, &APlatformTrigger::OnProximityEnd);
 }
 
 // Called when the game starts or when spawned
@@ -26,25 +40,112 @@ void APlatformTrigger::BeginPlay()
 {
 	Super::BeginPlay();
 
+	ProximityVolume->SetBoxExtent(TriggerVolume->GetUnscaledBoxExtent() + FVector(ProximityMargin));
 }
 
-// Called every frame
-void APlatformTrigger::Tick(float DeltaTime)
+void APlatformTrigger::OnOverlapBegin(class UPrimitiveComponent* OverlappedComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
-	Super::Tick(DeltaTime);
+	UDEMY_TICK_PROFILER_SCOPE(this, Triggers);
+
+	if (!IsTriggeringActor(OtherActor))
+		return;
 
+	int32& ComponentCount = OverlappingActors.FindOrAdd(OtherActor);
+	if (++ComponentCount == 1)
+		RequestStateUpdate();
 }
 
-void APlatformTrigger::OnOverlapBegin(class UPrimitiveComponent* OverlappedComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void APlatformTrigger::OnOverlapEnd(class UPrimitiveComponent* OverlappedComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
 {
-	for (AMovingPlatform* Platform : PlatformsToTrigger) {
-		Platform->AddActiveTrigger();
+	UDEMY_TICK_PROFILER_SCOPE(this, Triggers);
+
+	int32* ComponentCount = OverlappingActors.Find(OtherActor);
+	if (ComponentCount == nullptr)
+		return;
+
+	if (--(*ComponentCount) <= 0)
+	{
+		OverlappingActors.Remove(OtherActor);
+		RequestStateUpdate();
 	}
 }
 
-void APlatformTrigger::OnOverlapEnd(class UPrimitiveComponent* OverlappedComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+bool APlatformTrigger::IsTriggeringActor(AActor* Actor) const
+{
+	if (Actor == nullptr || Actor == this)
+		return false;
+
+	if (TriggeringActorClass != nullptr && !Actor->IsA(TriggeringActorClass))
+		return false;
+
+	return !PlatformsToTrigger.Contains(Actor);
+}
+
+void APlatformTrigger::RequestStateUpdate()
+{
+	if (bStateUpdatePending)
+		return;
+
+	// Every begin/end overlap of this frame collapses into one state change next tick
+	bStateUpdatePending = true;
+	GetWorldTimerManager().SetTimerForNextTick(this, &APlatformTrigger::ApplyState);
+}
+
+void APlatformTrigger::ApplyState()
 {
+	bStateUpdatePending = false;
+
+	for (auto It = OverlappingActors.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+			It.RemoveCurrent();
+	}
+
+	const bool bShouldBeActive = OverlappingActors.Num() > 0;
+	if (bShouldBeActive == bIsActive)
+		return;
+
+	bIsActive = bShouldBeActive;
+
+	// Platform phase is server-owned and replicated, clients only keep their overlap bookkeeping
+	if (GetNetMode() == NM_Client)
+		return;
+
 	for (AMovingPlatform* Platform : PlatformsToTrigger) {
-		Platform->RemoveActiveTrigger();
+		if (Platform == nullptr)
+			continue;
+
+		if (bIsActive)
+			Platform->AddActiveTrigger();
+		else
+			Platform->RemoveActiveTrigger();
 	}
+}
+
+void APlatformTrigger::OnProximityBegin(class UPrimitiveComponent* OverlappedComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	UDEMY_TICK_PROFILER_SCOPE(this, Triggers);
+
+	ACharacter* Character = Cast<ACharacter>(OtherActor);
+
+	if (Character == nullptr || OtherComp != Character->GetCapsuleComponent() || PlatformsToTrigger.Num() == 0)
+		return;
+
+	UOverlapRefreshSubsystem* OverlapRefresh = GetWorld()->GetSubsystem<UOverlapRefreshSubsystem>();
+	if (OverlapRefresh != nullptr)
+		OverlapRefresh->AddCharacterNearTrigger(Character);
+}
+
+void APlatformTrigger::OnProximityEnd(class UPrimitiveComponent* OverlappedComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+{
+	UDEMY_TICK_PROFILER_SCOPE(this, Triggers);
+
+	ACharacter* Character = Cast<ACharacter>(OtherActor);
+
+	if (Character == nullptr || OtherComp != Character->GetCapsuleComponent() || PlatformsToTrigger.Num() == 0)
+		return;
+
+	UOverlapRefreshSubsystem* OverlapRefresh = GetWorld()->GetSubsystem<UOverlapRefreshSubsystem>();
+	if (OverlapRefresh != nullptr)
+		OverlapRefresh->RemoveCharacterNearTrigger(Character);
 }
\ No newline at end of file
@@ -19,20 +19,43 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
-public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
 private:
 	UPROPERTY(VisibleAnywhere)
 	class UBoxComponent* TriggerVolume;
 
+	/** Characters inside this volume get their overlaps refreshed by UOverlapRefreshSubsystem */
+	UPROPERTY(VisibleAnywhere)
+	class UBoxComponent* ProximityVolume;
+
+	UPROPERTY(EditAnywhere)
+	float ProximityMargin = 200.0f;
+
 	UPROPERTY(EditAnywhere)
 	TArray<class AMovingPlatform*> PlatformsToTrigger;
 
+	/** Only actors of this class hold the trigger down */
+	UPROPERTY(EditAnywhere)
+	TSubclassOf<AActor> TriggeringActorClass;
+
+	// Overlapping components per actor, so an actor with several colliding components counts once
+	TMap<TWeakObjectPtr<AActor>, int32> OverlappingActors;
+
+	bool bIsActive = false;
+	bool bStateUpdatePending = false;
+
+	bool IsTriggeringActor(AActor* Actor) const;
+	void RequestStateUpdate();
+	void ApplyState();
+
 	UFUNCTION()
 	void OnOverlapBegin(class UPrimitiveComponent* OverlappedComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 
 	UFUNCTION()
 	void OnOverlapEnd(class UPrimitiveComponent* OverlappedComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
+
+	UFUNCTION()
+	void OnProximityBegin(class UPrimitiveComponent* OverlappedComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	UFUNCTION()
+	void OnProximityEnd(class UPrimitiveComponent* OverlappedComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
 };
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SessionLatencyProbe.h"
+
+#include "Icmp.h"
+
+void FSessionLatencyProbe::Start(const TMap<FString, FString>& HostAddressesBySessionId)
+{
+	Cancel();
+
+	PendingProbes.Reserve(HostAddressesBySessionId.Num());
+	for (const TPair<FString, FString>& HostAddress : HostAddressesBySessionId)
+	{
+		PendingProbes.Add(HostAddress);
+	}
+
+	LaunchProbes();
+}
+
+void FSessionLatencyProbe::Cancel()
+{
+	++Generation;
+	PendingProbes.Reset();
+
+	// Probes already sent still count against MaxConcurrentProbes until they answer or time out
+}
+
+void FSessionLatencyProbe::LaunchProbes()
+{
+	while (ProbesInFlight < MaxConcurrentProbes && PendingProbes.Num() > 0)
+	{
+		const TPair<FString, FString> Probe = PendingProbes.Pop(false);
+		++ProbesInFlight;
+
+		TWeakPtr<FSessionLatencyProbe> WeakThis = AsShared();
+		const uint32 ProbeGeneration = Generation;
+		const FString SessionId = Probe.Key;
+
+		FIcmp::IcmpEcho(Probe.Value, Timeout, [WeakThis, ProbeGeneration, SessionId](FIcmpEchoResult Result)
+		{
+			TSharedPtr<FSessionLatencyProbe> This = WeakThis.Pin();
+			if (This.IsValid())
+				This->ProbeComplete(ProbeGeneration, SessionId, Result.Status == EIcmpResponseStatus::Success, Result.Time);
+		});
+	}
+}
+
+void FSessionLatencyProbe::ProbeComplete(uint32 ProbeGeneration, const FString& SessionId, bool bSuccess, float Seconds)
+{
+	--ProbesInFlight;
+
+	if (bSuccess && ProbeGeneration == Generation)
+		OnLatencyMeasured.ExecuteIfBound(SessionId, FMath::RoundToInt(Seconds * 1000.0f));
+
+	LaunchProbes();
+}
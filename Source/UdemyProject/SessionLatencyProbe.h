@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Measures round-trip time to session hosts with ICMP echo, several hosts at a time.
+ * Results arrive on the game thread one by one as each host answers.
+ */
+class UDEMYPROJECT_API FSessionLatencyProbe : public TSharedFromThis<FSessionLatencyProbe>
+{
+public:
+	DECLARE_DELEGATE_TwoParams(FOnLatencyMeasured, const FString& /* SessionId */, int32 /* PingInMs */);
+
+	/** Cancels probes of a previous Start; their late results are dropped */
+	void Start(const TMap<FString, FString>& HostAddressesBySessionId);
+
+	void Cancel();
+
+	FOnLatencyMeasured OnLatencyMeasured;
+
+	int32 MaxConcurrentProbes = 16;
+	float Timeout = 1.0f;
+
+private:
+	void LaunchProbes();
+	void ProbeComplete(uint32 ProbeGeneration, const FString& SessionId, bool bSuccess, float Seconds);
+
+	TArray<TPair<FString, FString>> PendingProbes;
+
+	// Probes of every batch, a cancelled batch's probes drain before the new batch gets their slots
+	int32 ProbesInFlight = 0;
+
+	// Bumped on every Start/Cancel so results of older batches are ignored
+	uint32 Generation = 0;
+};
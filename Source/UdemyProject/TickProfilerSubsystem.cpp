@@ -0,0 +1,167 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TickProfilerSubsystem.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+UE_TRACE_CHANNEL_DEFINE(UdemyTickChannel);
+
+CSV_DEFINE_CATEGORY(UdemyTick, true);
+
+namespace
+{
+	TAutoConsoleVariable<bool> CVarTickProfilerEnable(
+		TEXT("udemy.TickProfiler.Enable"),
+		true,
+		TEXT("Time movement, platforms, triggers, replication and session callbacks every frame."));
+
+	TAutoConsoleVariable<float> CVarTickProfilerBudgetMs(
+		TEXT("udemy.TickProfiler.BudgetMs"),
+		33.3f,
+		TEXT("Game thread milliseconds a frame may take before a warning is logged. 0 disables the warning."));
+
+	TAutoConsoleVariable<int32> CVarTickProfilerWindow(
+		TEXT("udemy.TickProfiler.Window"),
+		600,
+		TEXT("Number of frames the percentiles are computed over."));
+
+	FAutoConsoleCommandWithWorld TickProfilerCommand(
+		TEXT("udemy.TickProfiler"),
+		TEXT("Prints p50/p95/p99 game thread milliseconds per category over the last frames."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			const UTickProfilerSubsystem* Profiler = World != nullptr ? World->GetSubsystem<UTickProfilerSubsystem>() : nullptr;
+			if (Profiler != nullptr)
+				Profiler->PrintStats();
+		}));
+
+	const TCHAR* CategoryNames[] = { TEXT("Movement"), TEXT("Dodge"), TEXT("Overlaps"), TEXT("Platforms"), TEXT("Triggers"), TEXT("Replication"), TEXT("Sessions") };
+	static_assert(UE_ARRAY_COUNT(CategoryNames) == (int32)ETickProfilerCategory::Num, "One name per tick profiler category");
+
+	float Percentile(const TArray<float>& Sorted, float Fraction)
+	{
+		return Sorted[FMath::Min(FMath::FloorToInt(Sorted.Num() * Fraction), Sorted.Num() - 1)];
+	}
+}
+
+const TCHAR* GetTickProfilerCategoryName(ETickProfilerCategory Category)
+{
+	return Category < ETickProfilerCategory::Num ? CategoryNames[(int32)Category] : TEXT("Frame");
+}
+
+FTickProfilerScope::FTickProfilerScope(const UObject* WorldContext, ETickProfilerCategory InCategory)
+	: Category(InCategory)
+{
+	if (!CVarTickProfilerEnable.GetValueOnGameThread() || WorldContext == nullptr)
+		return;
+
+	UWorld* World = WorldContext->GetWorld();
+	Profiler = World != nullptr ? World->GetSubsystem<UTickProfilerSubsystem>() : nullptr;
+
+	if (Profiler != nullptr)
+		StartTime = FPlatformTime::Seconds();
+}
+
+FTickProfilerScope::~FTickProfilerScope()
+{
+	if (Profiler != nullptr)
+		Profiler->AddTime(Category, FPlatformTime::Seconds() - StartTime);
+}
+
+void UTickProfilerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UTickProfilerSubsystem::OnWorldTickStart);
+}
+
+void UTickProfilerSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+
+	Super::Deinitialize();
+}
+
+void UTickProfilerSubsystem::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld())
+		return;
+
+	// The previous frame is complete once the next one starts
+	if (bFrameStarted && CVarTickProfilerEnable.GetValueOnGameThread())
+		EndFrame();
+
+	bFrameStarted = true;
+	FMemory::Memzero(CurrentFrame);
+}
+
+void UTickProfilerSubsystem::EndFrame()
+{
+	const int32 Window = FMath::Max(CVarTickProfilerWindow.GetValueOnGameThread(), 1);
+	if (History[0].Num() != Window)
+	{
+		for (TArray<float>& Series : History)
+			Series.SetNumZeroed(Window);
+
+		HistoryNext = 0;
+		HistoryCount = 0;
+	}
+
+	// A server sleeps to hold its tick rate, only the time spent working counts
+	const float FrameMs = FMath::Max(FApp::GetDeltaTime() - FApp::GetIdleTime(), 0.0) * 1000.0;
+
+	for (int32 i = 0; i < (int32)ETickProfilerCategory::Num; ++i)
+		History[i][HistoryNext] = CurrentFrame[i] * 1000.0;
+	History[NumSeries - 1][HistoryNext] = FrameMs;
+
+	HistoryNext = (HistoryNext + 1) % Window;
+	HistoryCount = FMath::Min(HistoryCount + 1, Window);
+
+#if CSV_PROFILER
+	if (FCsvProfiler::Get()->IsCapturing())
+	{
+		for (int32 i = 0; i < (int32)ETickProfilerCategory::Num; ++i)
+			FCsvProfiler::RecordCustomStat(CategoryNames[i], CSV_CATEGORY_INDEX(UdemyTick), CurrentFrame[i] * 1000.0, ECsvCustomStatOp::Set);
+	}
+#endif
+
+	const float BudgetMs = CVarTickProfilerBudgetMs.GetValueOnGameThread();
+	if (BudgetMs <= 0.0f || FrameMs <= BudgetMs)
+		return;
+
+	++FramesOverBudget;
+
+	// One warning a second is enough to spot a hitch without flooding the log of a struggling server
+	const double Now = FPlatformTime::Seconds();
+	if (Now - LastBudgetAlertTime < 1.0)
+		return;
+
+	LastBudgetAlertTime = Now;
+
+	FString Breakdown;
+	for (int32 i = 0; i < (int32)ETickProfilerCategory::Num; ++i)
+		Breakdown += FString::Printf(TEXT(" %s %.2f"), CategoryNames[i], CurrentFrame[i] * 1000.0);
+
+	UE_LOG(LogTemp, Warning, TEXT("Frame took %.2f ms of its %.2f ms budget in %s:%s"), FrameMs, BudgetMs, *GetWorld()->GetMapName(), *Breakdown);
+}
+
+void UTickProfilerSubsystem::PrintStats() const
+{
+	UE_LOG(LogTemp, Display, TEXT("Tick profiler of %s over %d frames, %d over budget"), *GetWorld()->GetMapName(), HistoryCount, FramesOverBudget);
+
+	if (HistoryCount == 0)
+		return;
+
+	for (int32 i = 0; i < NumSeries; ++i)
+	{
+		TArray<float> Sorted(History[i].GetData(), HistoryCount);
+		Sorted.Sort();
+
+		UE_LOG(LogTemp, Display, TEXT("  %s: p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms"),
+			GetTickProfilerCategoryName((ETickProfilerCategory)i), Percentile(Sorted, 0.5f), Percentile(Sorted, 0.95f), Percentile(Sorted, 0.99f), Sorted.Last());
+	}
+}
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Trace/Trace.h"
+#include "TickProfilerSubsystem.generated.h"
+
+/** Insights channel of the UDEMY_TICK_PROFILER_SCOPE events, enable it with -trace=cpu,UdemyTick */
+UE_TRACE_CHANNEL_EXTERN(UdemyTickChannel, UDEMYPROJECT_API);
+
+/**
+ * Game thread work the profiler breaks a frame into. Dodge is part of Movement, Triggers of whatever moved into them.
+ * Movement counts both the component tick and the moves of remote clients the server runs during the net tick.
+ */
+enum class ETickProfilerCategory : uint8
+{
+	Movement,
+	Dodge,
+	Overlaps,
+	Platforms,
+	Triggers,
+	Replication,
+	Sessions,
+	Num
+};
+
+const TCHAR* GetTickProfilerCategoryName(ETickProfilerCategory Category);
+
+/** Adds the time spent in its scope to the profiler of the context object's world */
+class UDEMYPROJECT_API FTickProfilerScope
+{
+public:
+	FTickProfilerScope(const UObject* WorldContext, ETickProfilerCategory InCategory);
+	~FTickProfilerScope();
+
+private:
+	class UTickProfilerSubsystem* Profiler = nullptr;
+	ETickProfilerCategory Category;
+	double StartTime = 0.0;
+};
+
+/** Times the rest of the enclosing block for the profiler and as an Insights event on UdemyTickChannel */
+#define UDEMY_TICK_PROFILER_SCOPE(WorldContext, Category) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("Udemy." #Category, UdemyTickChannel); \
+	FTickProfilerScope PREPROCESSOR_JOIN(TickProfilerScope, __LINE__)(WorldContext, ETickProfilerCategory::Category)
+
+/**
+ * Per-world game thread time of character movement, platforms, trigger callbacks, replication and session callbacks.
+ * Every frame is sent to the CSV profiler and kept in a rolling window for the p50/p95/p99 printed by udemy.TickProfiler,
+ * which also works on the console of a dedicated server. Frames over udemy.TickProfiler.BudgetMs log a warning with their breakdown.
+ */
+UCLASS()
+class UDEMYPROJECT_API UTickProfilerSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	void AddTime(ETickProfilerCategory Category, double Seconds) { CurrentFrame[(int32)Category] += Seconds; }
+
+	/** Seconds spent in a category so far this frame */
+	double GetCurrentFrameTime(ETickProfilerCategory Category) const { return CurrentFrame[(int32)Category]; }
+
+	void PrintStats() const;
+
+private:
+	static constexpr int32 NumSeries = (int32)ETickProfilerCategory::Num + 1;
+
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void EndFrame();
+
+	double CurrentFrame[(int32)ETickProfilerCategory::Num] = {};
+	bool bFrameStarted = false;
+
+	// Milliseconds of the last frames, one ring buffer per category, then the whole frame
+	TArray<float> History[NumSeries];
+	int32 HistoryNext = 0;
+	int32 HistoryCount = 0;
+
+	int32 FramesOverBudget = 0;
+	double LastBudgetAlertTime = 0.0;
+
+	FDelegateHandle WorldTickStartHandle;
+};
@@ -0,0 +1,305 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UdemyCharacterMovementComponent.h"
+
+#include "Curves/CurveFloat.h"
+#include "GameFramework/Character.h"
+
+#include "AssetPreloadSubsystem.h"
+#include "LoadReportSubsystem.h"
+#include "TickProfilerSubsystem.h"
+
+UUdemyCharacterMovementComponent::UUdemyCharacterMovementComponent()
+{
+	DodgeCurve = TSoftObjectPtr<UCurveFloat>(FSoftObjectPath(TEXT("/Game/Udemy/Character/Dodge/CV_Dodge.CV_Dodge")));
+
+	MaxSprintSpeed = 800.0f;
+	DodgeDistance = 500.0f;
+	DodgeDuration = 0.25f;
+	DodgeCooldown = 0.4f;
+	DodgeInputBuffer = 0.2f;
+	DodgeStart = FVector::ZeroVector;
+	DodgeTarget = FVector::ZeroVector;
+}
+
+void UUdemyCharacterMovementComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Loaded before the first move so the client and the server evaluate the same curve
+	LoadedDodgeCurve = UAssetPreloadSubsystem::Load(this, DodgeCurve);
+}
+
+void UUdemyCharacterMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	UDEMY_TICK_PROFILER_SCOPE(this, Movement);
+
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+}
+
+FNetworkPredictionData_Client* UUdemyCharacterMovementComponent::GetPredictionData_Client() const
+{
+	check(PawnOwner != nullptr);
+
+	if (ClientPredictionData == nullptr)
+	{
+		UUdemyCharacterMovementComponent* MutableThis = const_cast<UUdemyCharacterMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Udemy(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+void UUdemyCharacterMovementComponent::SetSprinting(bool bSprinting)
+{
+	bWantsToSprint = bSprinting;
+}
+
+float UUdemyCharacterMovementComponent::GetMaxSpeed() const
+{
+	if (bWantsToSprint && MovementMode == MOVE_Walking)
+		return MaxSprintSpeed;
+
+	return Super::GetMaxSpeed();
+}
+
+void UUdemyCharacterMovementComponent::RequestDodge()
+{
+	bWantsToDodge = true;
+	DodgeBufferLeft = DodgeInputBuffer;
+}
+
+bool UUdemyCharacterMovementComponent::IsDodging() const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == CMOVE_Dodge;
+}
+
+void UUdemyCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	bWantsToSprint = (Flags & FSavedMove_Character::FLAG_Custom_1) != 0;
+	bWantsToDodge = (Flags & FSavedMove_Character::FLAG_Custom_0) != 0;
+}
+
+void UUdemyCharacterMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
+{
+	Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+
+	DodgeCooldownLeft = FMath::Max(DodgeCooldownLeft - DeltaSeconds, 0.0f);
+
+	// Runs on the owning client and again on the server when it replays the move,
+	// so both sides start the dodge from the same location in the same move.
+	if (bWantsToDodge)
+	{
+		if (CanDodge())
+		{
+			bWantsToDodge = false;
+			StartDodge();
+		}
+		else
+		{
+			// The owning client keeps sending the request until the buffer runs out, the server only acts on each move's flag
+			DodgeBufferLeft -= DeltaSeconds;
+			if (DodgeBufferLeft <= 0.0f || CharacterOwner == nullptr || !CharacterOwner->IsLocallyControlled())
+				bWantsToDodge = false;
+		}
+	}
+}
+
+void UUdemyCharacterMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
+{
+	Super::PhysCustom(deltaTime, Iterations);
+
+	switch (CustomMovementMode)
+	{
+	case CMOVE_Dodge:
+		PhysDodge(deltaTime, Iterations);
+		break;
+	default:
+		UE_LOG(LogTemp, Warning, TEXT("Invalid custom movement mode %d"), CustomMovementMode);
+		break;
+	}
+}
+
+void UUdemyCharacterMovementComponent::MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel)
+{
+	UDEMY_TICK_PROFILER_SCOPE(this, Movement);
+
+	Super::MoveAutonomous(ClientTimeStamp, DeltaTime, CompressedFlags, NewAccel);
+}
+
+bool UUdemyCharacterMovementComponent::ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientLoc, const FVector& RelativeClientLoc, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+{
+	const bool bNeedsCorrection = Super::ServerCheckClientError(ClientTimeStamp, DeltaTime, Accel, ClientLoc, RelativeClientLoc, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+
+	if (bNeedsCorrection)
+	{
+		ULoadReportSubsystem* LoadReport = GetWorld() != nullptr ? GetWorld()->GetSubsystem<ULoadReportSubsystem>() : nullptr;
+		if (LoadReport != nullptr)
+			LoadReport->AddCorrection();
+	}
+
+	return bNeedsCorrection;
+}
+
+bool UUdemyCharacterMovementComponent::CanDodge() const
+{
+	return UpdatedComponent != nullptr
+		&& !IsDodging()
+		&& DodgeCooldownLeft <= 0.0f
+		&& (IsMovingOnGround() || IsFalling())
+		&& !GetCurrentAcceleration().IsNearlyZero();
+}
+
+void UUdemyCharacterMovementComponent::StartDodge()
+{
+	// Acceleration is part of every move sent to the server, so the direction needs no extra payload
+	const FVector Direction = GetCurrentAcceleration().GetSafeNormal2D();
+
+	// No trace up front: PhysDodge sweeps the capsule on every step and stops at the first wall
+	DodgeStart = UpdatedComponent->GetComponentLocation();
+	DodgeTarget = DodgeStart + Direction * DodgeDistance;
+
+	DodgeElapsed = 0.0f;
+	SetMovementMode(MOVE_Custom, CMOVE_Dodge);
+}
+
+void UUdemyCharacterMovementComponent::EndDodge()
+{
+	FFindFloorResult FloorResult;
+	FindFloor(UpdatedComponent->GetComponentLocation(), FloorResult, false);
+
+	Velocity = Velocity.GetClampedToMaxSize2D(MaxWalkSpeed);
+	DodgeCooldownLeft = DodgeCooldown;
+	SetMovementMode(FloorResult.IsWalkableFloor() ? MOVE_Walking : MOVE_Falling);
+}
+
+void UUdemyCharacterMovementComponent::PhysDodge(float deltaTime, int32 Iterations)
+{
+	if (deltaTime < MIN_TICK_TIME)
+		return;
+
+	UDEMY_TICK_PROFILER_SCOPE(this, Dodge);
+
+	DodgeElapsed = FMath::Min(DodgeElapsed + deltaTime, DodgeDuration);
+
+	const float Alpha = DodgeDuration > 0.0f ? DodgeElapsed / DodgeDuration : 1.0f;
+	const float CurveAlpha = LoadedDodgeCurve != nullptr ? LoadedDodgeCurve->GetFloatValue(Alpha) : Alpha;
+
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	FVector Delta = FMath::Lerp(DodgeStart, DodgeTarget, CurveAlpha) - OldLocation;
+	Delta.Z = 0.0f;
+
+	// The capsule sweep catches low obstacles a trace from the capsule center would pass over
+	FHitResult Hit(1.0f);
+	SafeMoveUpdatedComponent(Delta, UpdatedComponent->GetComponentQuat(), true, Hit);
+
+	if (Hit.IsValidBlockingHit())
+	{
+		// A wall ends the dodge where the capsule touched it, a slope is slid up
+		if (!IsWalkable(Hit))
+		{
+			Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / deltaTime;
+			EndDodge();
+			return;
+		}
+
+		SlideAlongSurface(Delta, 1.0f - Hit.Time, Hit.Normal, Hit, true);
+	}
+
+	if (!bJustTeleported)
+	{
+		Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / deltaTime;
+	}
+
+	if (DodgeElapsed >= DodgeDuration)
+	{
+		EndDodge();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FSavedMove_Udemy
+
+void UUdemyCharacterMovementComponent::FSavedMove_Udemy::Clear()
+{
+	Super::Clear();
+
+	bSavedWantsToSprint = false;
+	bSavedWantsToDodge = false;
+	SavedDodgeElapsed = 0.0f;
+	SavedDodgeCooldownLeft = 0.0f;
+	SavedDodgeStart = FVector::ZeroVector;
+	SavedDodgeTarget = FVector::ZeroVector;
+}
+
+uint8 UUdemyCharacterMovementComponent::FSavedMove_Udemy::GetCompressedFlags() const
+{
+	uint8 Result = Super::GetCompressedFlags();
+
+	if (bSavedWantsToSprint)
+		Result |= FLAG_Custom_1;
+
+	if (bSavedWantsToDodge)
+		Result |= FLAG_Custom_0;
+
+	return Result;
+}
+
+bool UUdemyCharacterMovementComponent::FSavedMove_Udemy::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	const FSavedMove_Udemy* NewUdemyMove = static_cast<const FSavedMove_Udemy*>(NewMove.Get());
+
+	if (bSavedWantsToSprint != NewUdemyMove->bSavedWantsToSprint)
+		return false;
+
+	if (bSavedWantsToDodge != NewUdemyMove->bSavedWantsToDodge)
+		return false;
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void UUdemyCharacterMovementComponent::FSavedMove_Udemy::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	const UUdemyCharacterMovementComponent* MovementComponent = Cast<UUdemyCharacterMovementComponent>(C->GetCharacterMovement());
+	if (MovementComponent == nullptr)
+		return;
+
+	bSavedWantsToSprint = MovementComponent->bWantsToSprint;
+	bSavedWantsToDodge = MovementComponent->bWantsToDodge;
+	SavedDodgeElapsed = MovementComponent->DodgeElapsed;
+	SavedDodgeCooldownLeft = MovementComponent->DodgeCooldownLeft;
+	SavedDodgeStart = MovementComponent->DodgeStart;
+	SavedDodgeTarget = MovementComponent->DodgeTarget;
+}
+
+void UUdemyCharacterMovementComponent::FSavedMove_Udemy::PrepMoveFor(ACharacter* C)
+{
+	Super::PrepMoveFor(C);
+
+	UUdemyCharacterMovementComponent* MovementComponent = Cast<UUdemyCharacterMovementComponent>(C->GetCharacterMovement());
+	if (MovementComponent == nullptr)
+		return;
+
+	MovementComponent->DodgeElapsed = SavedDodgeElapsed;
+	MovementComponent->DodgeCooldownLeft = SavedDodgeCooldownLeft;
+	MovementComponent->DodgeStart = SavedDodgeStart;
+	MovementComponent->DodgeTarget = SavedDodgeTarget;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FNetworkPredictionData_Client_Udemy
+
+UUdemyCharacterMovementComponent::FNetworkPredictionData_Client_Udemy::FNetworkPredictionData_Client_Udemy(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
+{
+}
+
+FSavedMovePtr UUdemyCharacterMovementComponent::FNetworkPredictionData_Client_Udemy::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_Udemy());
+}
@@ -0,0 +1,136 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "UdemyCharacterMovementComponent.generated.h"
+
+class UCurveFloat;
+
+UENUM(BlueprintType)
+enum ECustomMovementMode
+{
+	CMOVE_None		UMETA(Hidden),
+	CMOVE_Dodge		UMETA(DisplayName = "Dodge"),
+	CMOVE_MAX		UMETA(Hidden),
+};
+
+/**
+ * Character movement with client-predicted sprint and dodge.
+ * The dodge request travels as a compressed flag on the saved move, so the server replays it
+ * inside the same move instead of correcting a locally teleported client.
+ */
+UCLASS()
+class UDEMYPROJECT_API UUdemyCharacterMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+	class FSavedMove_Udemy : public FSavedMove_Character
+	{
+	public:
+		typedef FSavedMove_Character Super;
+
+		virtual void Clear() override;
+		virtual uint8 GetCompressedFlags() const override;
+		virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+		virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+		virtual void PrepMoveFor(ACharacter* C) override;
+
+		uint8 bSavedWantsToSprint : 1;
+		uint8 bSavedWantsToDodge : 1;
+
+		// Dodge progress at the start of the move, restored when the move is replayed after a correction
+		float SavedDodgeElapsed;
+		float SavedDodgeCooldownLeft;
+		FVector SavedDodgeStart;
+		FVector SavedDodgeTarget;
+	};
+
+	class FNetworkPredictionData_Client_Udemy : public FNetworkPredictionData_Client_Character
+	{
+	public:
+		typedef FNetworkPredictionData_Client_Character Super;
+
+		FNetworkPredictionData_Client_Udemy(const UCharacterMovementComponent& ClientMovement);
+
+		virtual FSavedMovePtr AllocateNewMove() override;
+	};
+
+public:
+	UUdemyCharacterMovementComponent();
+
+	virtual void BeginPlay() override;
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+	/** Sprint state is sent with every move so the server simulates the same max speed */
+	void SetSprinting(bool bSprinting);
+
+	bool IsSprinting() const { return bWantsToSprint; }
+
+	const TSoftObjectPtr<UCurveFloat>& GetDodgeCurve() const { return DodgeCurve; }
+
+	virtual float GetMaxSpeed() const override;
+
+	/**
+	 * Asks for a dodge on the next movement update. Call on the locally controlled character.
+	 * A request that comes while the dodge is not possible yet, e.g. during the cooldown, is kept for DodgeInputBuffer seconds.
+	 */
+	void RequestDodge();
+
+	bool IsDodging() const;
+
+protected:
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+
+	virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
+
+	virtual void PhysCustom(float deltaTime, int32 Iterations) override;
+
+	/** Moves received from a remote client run here during the net tick, outside TickComponent */
+	virtual void MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel) override;
+
+	virtual bool ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientLoc, const FVector& RelativeClientLoc, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) override;
+
+private:
+	UPROPERTY(EditAnywhere, Category = "Sprint Option")
+	float MaxSprintSpeed;
+
+	UPROPERTY(EditAnywhere, Category = "Dodge Option")
+	float DodgeDistance;
+
+	UPROPERTY(EditAnywhere, Category = "Dodge Option")
+	float DodgeDuration;
+
+	// Seconds after a dodge ends before the next one can start
+	UPROPERTY(EditAnywhere, Category = "Dodge Option")
+	float DodgeCooldown;
+
+	// Seconds a press is remembered when it cannot dodge right away
+	UPROPERTY(EditAnywhere, Category = "Dodge Option")
+	float DodgeInputBuffer;
+
+	// Loaded in BeginPlay, a linear dodge is used without it
+	UPROPERTY(EditAnywhere, Category = "Dodge Option")
+	TSoftObjectPtr<UCurveFloat> DodgeCurve;
+
+	UPROPERTY(Transient)
+	UCurveFloat* LoadedDodgeCurve = nullptr;
+
+	bool CanDodge() const;
+	void StartDodge();
+	void EndDodge();
+	void PhysDodge(float deltaTime, int32 Iterations);
+
+	bool bWantsToSprint = false;
+	bool bWantsToDodge = false;
+
+	float DodgeElapsed = 0.0f;
+	float DodgeCooldownLeft = 0.0f;
+	float DodgeBufferLeft = 0.0f;
+	FVector DodgeStart;
+	FVector DodgeTarget;
+};
@@ -4,31 +4,35 @@
 #include "UdemyPlatformGameInstance.h"
 
 #include "Engine/Engine.h"
-#include "UObject/ConstructorHelpers.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
 #include "Blueprint/UserWidget.h"
+#include "TimerManager.h"
+#include "Misc/NetworkVersion.h"
 
+#include "AssetPreloadSubsystem.h"
+#include "HostMigrationSubsystem.h"
 #include "PlatformTrigger.h"
+#include "SessionLatencyProbe.h"
+#include "TickProfilerSubsystem.h"
+#include "UdemyCharacterMovementComponent.h"
+#include "UdemyProjectGameMode.h"
 #include "MenuSystem/MainMenu.h"
 #include "MenuSystem/MenuWidget.h"
+#include "MenuSystem/ServerListModel.h"
 #include "OnlineSessionSettings.h"
 #include "Online/OnlineSessionNames.h"
 
 const static FName SESSION_NAME = TEXT("Game");
 const static FName SERVER_NAME_SETTINGS_KEY = TEXT("ServerName");
+const static FName BUILD_VERSION_SETTINGS_KEY = TEXT("BuildVersion");
+const static FName HOST_KEY_SETTINGS_KEY = TEXT("HostKey");
 
 UUdemyPlatformGameInstance::UUdemyPlatformGameInstance(const FObjectInitializer& ObjectInitializer)
 {
-	ConstructorHelpers::FClassFinder<UUserWidget> MenuBPClass(TEXT("/Game/Udemy/WBP_MainMenu"));
-	if (MenuBPClass.Class != nullptr)
-	{
-		MenuClass = MenuBPClass.Class;
-	}
-	
-	ConstructorHelpers::FClassFinder<UUserWidget> InGameMenuBPClass(TEXT("/Game/Udemy/WBP_InGameMenu"));
-	if (InGameMenuBPClass.Class != nullptr)
-	{
-		InGameMenuClass = InGameMenuBPClass.Class;
-	}
+	// Only paths, the widget blueprints are loaded after startup and never on a dedicated server
+	MenuClass = TSoftClassPtr<UUserWidget>(FSoftObjectPath(TEXT("/Game/Udemy/WBP_MainMenu.WBP_MainMenu_C")));
+	InGameMenuClass = TSoftClassPtr<UUserWidget>(FSoftObjectPath(TEXT("/Game/Udemy/WBP_InGameMenu.WBP_InGameMenu_C")));
 }
 
 // Play할 때 실행됨
@@ -52,34 +56,88 @@ void UUdemyPlatformGameInstance::Init()
 		UE_LOG(LogTemp, Warning, TEXT("Found no subsystem"));
 	}
 
+	UAssetPreloadSubsystem* AssetPreload = GetSubsystem<UAssetPreloadSubsystem>();
+	if (AssetPreload != nullptr)
+	{
+		// Servers simulate every pawn's dodge too, so the character group is loaded on every process
+		AssetPreload->Preload(TEXT("Character"), {
+			GetDefault<AUdemyProjectGameMode>()->GetDefaultPawnSoftClass().ToSoftObjectPath(),
+			GetDefault<UUdemyCharacterMovementComponent>()->GetDodgeCurve().ToSoftObjectPath() });
+
+		if (!IsRunningDedicatedServer())
+			AssetPreload->Preload(TEXT("Menus"), { MenuClass.ToSoftObjectPath(), InGameMenuClass.ToSoftObjectPath() });
+	}
+
+	LatencyProbe = MakeShared<FSessionLatencyProbe>();
+	LatencyProbe->OnLatencyMeasured.BindUObject(this, &UUdemyPlatformGameInstance::OnLatencyMeasured);
+
 	if (GEngine != nullptr)
 	{
 		// HOST가 끊겼을 시 실행됨.
 		GEngine->OnNetworkFailure().AddUObject(this, &UUdemyPlatformGameInstance::OnNetworkFailure);
+		GEngine->OnTravelFailure().AddUObject(this, &UUdemyPlatformGameInstance::OnTravelFailure);
+	}
+
+	FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UUdemyPlatformGameInstance::OnPostLoadMap);
+
+	// A dedicated server starts in the lobby (ServerDefaultMap) and advertises itself right away
+	if (IsRunningDedicatedServer())
+	{
+		if (!FParse::Value(FCommandLine::Get(), TEXT("ServerName="), DesiredServerName))
+			DesiredServerName = TEXT("Dedicated Server");
+
+		CreateSession();
 	}
 }
 
 void UUdemyPlatformGameInstance::LoadMenu()
 {
-	Menu = CreateWidget<UMainMenu>(this, MenuClass);
-
-	if (!ensure(Menu != nullptr))
+	// The engine falls back to the menu map while the reconnect or the host migration is in progress
+	if (bReconnecting || bMigrating)
 		return;
 
+	ReleaseMenusOfOtherWorlds();
+
+	if (Menu == nullptr)
+	{
+		Menu = CreateWidget<UMainMenu>(this, UAssetPreloadSubsystem::Load(this, MenuClass));
+
+		if (!ensure(Menu != nullptr))
+			return;
+
+		Menu->SetMenuInterface(this);
+	}
+
 	Menu->Setup();
-	Menu->SetMenuInterface(this);
 }
 
 // 숫자키 1번 누르면 인게임 메뉴 실행됨
 void UUdemyPlatformGameInstance::InGameLoadMenu()
 {
-	UMenuWidget* InGameMenu = CreateWidget<UMenuWidget>(this, InGameMenuClass);
+	ReleaseMenusOfOtherWorlds();
 
-	if (!ensure(InGameMenu != nullptr))
-		return;
+	// Created on the first open, then only shown and hidden
+	if (InGameMenu == nullptr)
+	{
+		InGameMenu = CreateWidget<UMenuWidget>(this, UAssetPreloadSubsystem::Load(this, InGameMenuClass));
+
+		if (!ensure(InGameMenu != nullptr))
+			return;
+
+		InGameMenu->SetMenuInterface(this);
+	}
 
 	InGameMenu->Setup();
-	InGameMenu->SetMenuInterface(this);
+}
+
+void UUdemyPlatformGameInstance::ReleaseMenusOfOtherWorlds()
+{
+	if (MenuWorld == GetWorld())
+		return;
+
+	Menu = nullptr;
+	InGameMenu = nullptr;
+	MenuWorld = GetWorld();
 }
 
 void UUdemyPlatformGameInstance::Host(FString ServerName)
@@ -104,12 +162,21 @@ void UUdemyPlatformGameInstance::Host(FString ServerName)
 
 void UUdemyPlatformGameInstance::OnCreateSessionComplete(FName SessionName, bool Success)
 {
+	UDEMY_TICK_PROFILER_SCOPE(this, Sessions);
+
 	if (!Success)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Could not create session"));
 		return;
 	}
 
+	// Already in the lobby, it only had to be advertised
+	if (IsRunningDedicatedServer())
+	{
+		UE_LOG(LogTemp, Log, TEXT("Dedicated server session %s registered"), *DesiredServerName);
+		return;
+	}
+
 	if (Menu != nullptr)
 		Menu->Teardown();
 
@@ -119,23 +186,306 @@ void UUdemyPlatformGameInstance::OnCreateSessionComplete(FName SessionName, bool
 
 	UWorld* World = GetWorld();
 
+	// A migrated host carries on with the map the old host was playing
+	const FString Map = bMigrating && !MigrationMap.IsEmpty() ? MigrationMap : TEXT("/Game/Udemy/Lobby");
+
 	// 로비로 맵 이동
 	if (World != nullptr) {
-		World->ServerTravel("/Game/Udemy/Lobby?listen");
+		World->ServerTravel(Map + TEXT("?listen"));
 	}
 }
 
 void UUdemyPlatformGameInstance::OnDestroySessionComplete(FName SessionName, bool Success)
 {
+	UDEMY_TICK_PROFILER_SCOPE(this, Sessions);
+
+	// Leaving the old host's session during a migration, only the elected host creates one
+	if (bMigrating && !bMigrationHosting)
+		return;
+
+	// Left the session of a quick match candidate that could not be reached, the engine may report leaving it too
+	if (bQuickMatching)
+	{
+		if (bQuickMatchLeavingSession)
+		{
+			bQuickMatchLeavingSession = false;
+			TryQuickMatchJoin();
+		}
+		return;
+	}
+
 	if (Success)
 		CreateSession();
 }
 
 void UUdemyPlatformGameInstance::OnNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString)
 {
+	UDEMY_TICK_PROFILER_SCOPE(this, Sessions);
+
+	UE_LOG(LogTemp, Warning, TEXT("Network failure %s : %s"), ENetworkFailure::ToString(FailureType), *ErrorString);
+
+	// The joined candidate could not be reached, the quick match goes on with the next one
+	if (bQuickMatchTraveling)
+	{
+		GetTimerManager().SetTimer(QuickMatchRetryTimer, this, &UUdemyPlatformGameInstance::RetryQuickMatch, QuickMatchRetryDelay);
+		return;
+	}
+
+	if (bReconnecting)
+	{
+		// The attempt itself failed, e.g. the server is not reachable yet
+		ScheduleReconnectAttempt();
+		return;
+	}
+
+	// A failed join of the new host lands back on the default map, where the migration goes on
+	if (bMigrating)
+		return;
+
+	// Only a client that lost its server comes back, being kicked or running another version does not
+	const bool bLostServer = NetDriver != nullptr && NetDriver->ServerConnection != nullptr;
+	const bool bTransient = FailureType == ENetworkFailure::ConnectionLost
+		|| FailureType == ENetworkFailure::ConnectionTimeout;
+
+	// A listen server host takes the game with it, one of the remaining players has to host it
+	UHostMigrationSubsystem* HostMigration = GetSubsystem<UHostMigrationSubsystem>();
+	if (bLostServer && bTransient && HostMigration != nullptr && HostMigration->GetSnapshot().IsSet())
+	{
+		StartHostMigration();
+		return;
+	}
+
+	if (bLostServer && bTransient && !LastConnectAddress.IsEmpty())
+	{
+		StartReconnect();
+		return;
+	}
+
 	LoadMainMenu();
 }
 
+void UUdemyPlatformGameInstance::OnTravelFailure(UWorld* World, ETravelFailure::Type FailureType, const FString& ErrorString)
+{
+	if (bQuickMatchTraveling)
+		GetTimerManager().SetTimer(QuickMatchRetryTimer, this, &UUdemyPlatformGameInstance::RetryQuickMatch, QuickMatchRetryDelay);
+
+	if (bReconnecting)
+		ScheduleReconnectAttempt();
+}
+
+void UUdemyPlatformGameInstance::StartReconnect()
+{
+	UE_LOG(LogTemp, Warning, TEXT("Connection to %s lost, reconnecting"), *LastConnectAddress);
+
+	bReconnecting = true;
+	ReconnectAttempts = 0;
+	ReconnectStartTime = FPlatformTime::Seconds();
+
+	ScheduleReconnectAttempt();
+}
+
+void UUdemyPlatformGameInstance::ScheduleReconnectAttempt()
+{
+	// Several failure callbacks can report the same failed attempt
+	if (GetTimerManager().IsTimerActive(ReconnectTimer))
+		return;
+
+	if (ReconnectAttempts >= MaxReconnectAttempts)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Could not reconnect after %d attempts"), ReconnectAttempts);
+
+		StopReconnect();
+		LoadMainMenu();
+		return;
+	}
+
+	const float Delay = FMath::Min(ReconnectInitialDelay * FMath::Pow(2.0f, (float)ReconnectAttempts), ReconnectMaxDelay);
+	GetTimerManager().SetTimer(ReconnectTimer, this, &UUdemyPlatformGameInstance::TryReconnect, Delay);
+}
+
+void UUdemyPlatformGameInstance::TryReconnect()
+{
+	++ReconnectAttempts;
+
+	UE_LOG(LogTemp, Log, TEXT("Reconnect attempt %d to %s"), ReconnectAttempts, *LastConnectAddress);
+
+	// A new connection would not get through the outage either, the attempt fails like an unreachable server
+	if (FPlatformTime::Seconds() < SimulatedOutageEnd)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Server unreachable during the simulated outage"));
+		GetTimerManager().ClearTimer(ReconnectTimer);
+		ScheduleReconnectAttempt();
+		return;
+	}
+
+	// The session is joined again first if it was dropped locally, its completion travels
+	if (SessionInterface.IsValid() && SessionInterface->GetNamedSession(SESSION_NAME) == nullptr && LastJoinedSession.IsSet())
+	{
+		if (SessionInterface->JoinSession(0, SESSION_NAME, LastJoinedSession.GetValue()))
+			return;
+	}
+
+	GEngine->SetClientTravel(GetWorld(), *LastConnectAddress, ETravelType::TRAVEL_Absolute);
+}
+
+void UUdemyPlatformGameInstance::StopReconnect()
+{
+	GetTimerManager().ClearTimer(ReconnectTimer);
+	bReconnecting = false;
+	ReconnectAttempts = 0;
+}
+
+void UUdemyPlatformGameInstance::StartHostMigration()
+{
+	UHostMigrationSubsystem* HostMigration = GetSubsystem<UHostMigrationSubsystem>();
+	const FHostMigrationSnapshot& Snapshot = HostMigration->GetSnapshot().GetValue();
+
+	// The snapshot goes away with the world, keep what the migration needs
+	OldHostKey = Snapshot.HostKey;
+	ElectedHostKey = HostMigration->ElectHost();
+	MigrationMap = Snapshot.MapName;
+	DesiredServerName = Snapshot.ServerName;
+
+	if (ElectedHostKey.IsEmpty())
+	{
+		LoadMainMenu();
+		return;
+	}
+
+	const bool bElected = ElectedHostKey == HostMigration->GetLocalPlayerKey();
+	UE_LOG(LogTemp, Warning, TEXT("Host %s lost, %s takes over"), *OldHostKey, bElected ? TEXT("this player") : *ElectedHostKey);
+
+	if (bElected)
+		HostMigration->BeginRestore(Snapshot);
+
+	bMigrating = true;
+	bMigrationHosting = false;
+	MigrationStartTime = FPlatformTime::Seconds();
+
+	// Cached results from before the drop can still list the departed host's session, only a new search counts
+	CachedSearchResults.Reset();
+	ServerList.Reset();
+	ServerIndexBySessionId.Reset();
+	LastSessionSearchTime.Reset();
+
+	// The new session is created or joined once a search has run on the default map
+	if (SessionInterface.IsValid() && SessionInterface->GetNamedSession(SESSION_NAME) != nullptr)
+		SessionInterface->DestroySession(SESSION_NAME);
+
+	GetTimerManager().SetTimer(MigrationTimeoutTimer, this, &UUdemyPlatformGameInstance::OnHostMigrationTimeout, MigrationTimeout);
+}
+
+void UUdemyPlatformGameInstance::ContinueHostMigration()
+{
+	if (!bMigrating || bMigrationHosting)
+		return;
+
+	// Still advertised, so only this player lost the connection
+	int32 Index = FindCachedSessionOfHost(OldHostKey);
+
+	if (Index == INDEX_NONE)
+	{
+		const UHostMigrationSubsystem* HostMigration = GetSubsystem<UHostMigrationSubsystem>();
+		if (HostMigration != nullptr && ElectedHostKey == HostMigration->GetLocalPlayerKey())
+		{
+			bMigrationHosting = true;
+			Host(DesiredServerName);
+			return;
+		}
+
+		Index = FindCachedSessionOfHost(ElectedHostKey);
+	}
+
+	if (Index != INDEX_NONE)
+	{
+		Join(Index);
+		return;
+	}
+
+	// The new host is not advertising yet
+	GetTimerManager().SetTimer(MigrationSearchTimer, this, &UUdemyPlatformGameInstance::FindSessions, MigrationSearchRetryDelay);
+}
+
+int32 UUdemyPlatformGameInstance::FindCachedSessionOfHost(const FString& HostKey) const
+{
+	if (HostKey.IsEmpty())
+		return INDEX_NONE;
+
+	return CachedSearchResults.IndexOfByPredicate([&HostKey](const FOnlineSessionSearchResult& SearchResult)
+	{
+		FString SessionHostKey;
+		return SearchResult.Session.SessionSettings.Get(HOST_KEY_SETTINGS_KEY, SessionHostKey) && SessionHostKey == HostKey;
+	});
+}
+
+void UUdemyPlatformGameInstance::OnHostMigrationTimeout()
+{
+	UE_LOG(LogTemp, Warning, TEXT("Host migration gave up after %.0f s"), MigrationTimeout);
+
+	StopHostMigration();
+	LoadMenu();
+}
+
+void UUdemyPlatformGameInstance::StopHostMigration()
+{
+	GetTimerManager().ClearTimer(MigrationTimeoutTimer);
+	GetTimerManager().ClearTimer(MigrationSearchTimer);
+	bMigrating = false;
+	bMigrationHosting = false;
+}
+
+void UUdemyPlatformGameInstance::SimulateConnectionDrop(float Seconds)
+{
+#if DO_ENABLE_NET_TEST
+	UWorld* World = GetWorld();
+	UNetDriver* NetDriver = World != nullptr ? World->GetNetDriver() : nullptr;
+
+	if (NetDriver == nullptr || NetDriver->ServerConnection == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Not connected to a server"));
+		return;
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("Simulating a %.1f s network outage"), Seconds);
+
+	// Nothing is closed, both sides only notice through their ConnectionTimeout like on a real outage
+	SimulatedOutageStart = FPlatformTime::Seconds();
+	SimulatedOutageEnd = SimulatedOutageStart.GetValue() + Seconds;
+	SetSimulatedPacketLoss(100);
+
+	GetTimerManager().SetTimer(SimulatedOutageTimer, this, &UUdemyPlatformGameInstance::EndSimulatedOutage, Seconds);
+#else
+	UE_LOG(LogTemp, Warning, TEXT("Packet simulation is not available in this build"));
+#endif
+}
+
+void UUdemyPlatformGameInstance::SetSimulatedPacketLoss(int32 Percent)
+{
+#if DO_ENABLE_NET_TEST
+	UWorld* World = GetWorld();
+	UNetDriver* NetDriver = World != nullptr ? World->GetNetDriver() : nullptr;
+	if (NetDriver == nullptr)
+		return;
+
+	FPacketSimulationSettings Settings = NetDriver->PacketSimulationSettings;
+	Settings.PktLoss = Percent;
+	NetDriver->SetPacketSimulationSettings(Settings);
+#endif
+}
+
+void UUdemyPlatformGameInstance::EndSimulatedOutage()
+{
+	// A connection that timed out took its net driver with it, the reconnect uses a new one
+	SetSimulatedPacketLoss(0);
+
+	const UWorld* World = GetWorld();
+	if (!bReconnecting && World != nullptr && World->GetNetMode() == NM_Client)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Connection survived the %.1f s outage"), SimulatedOutageEnd - SimulatedOutageStart.Get(0.0));
+		SimulatedOutageStart.Reset();
+	}
+}
+
 void UUdemyPlatformGameInstance::CreateSession()
 {
 	if (SessionInterface.IsValid())
@@ -147,10 +497,18 @@ void UUdemyPlatformGameInstance::CreateSession()
 		else
 			SessionSettings.bIsLANMatch = false;
 
-		SessionSettings.NumPublicConnections = 5;
+		SessionSettings.NumPublicConnections = FMath::Clamp(MaxPlayers, 2, 64);
 		SessionSettings.bShouldAdvertise = true;
-		SessionSettings.bUsesPresence = true;
+		// No local user owns a dedicated session, so it cannot use presence
+		SessionSettings.bIsDedicated = IsRunningDedicatedServer();
+		SessionSettings.bUsesPresence = !SessionSettings.bIsDedicated;
 		SessionSettings.Set(SERVER_NAME_SETTINGS_KEY, DesiredServerName, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing);
+		SessionSettings.Set(BUILD_VERSION_SETTINGS_KEY, (int32)FNetworkVersion::GetLocalNetworkVersion(), EOnlineDataAdvertisementType::ViaOnlineServiceAndPing);
+
+		// Lets the players of a host migration recognise the session of the host they elected
+		const UHostMigrationSubsystem* HostMigration = GetSubsystem<UHostMigrationSubsystem>();
+		if (HostMigration != nullptr)
+			SessionSettings.Set(HOST_KEY_SETTINGS_KEY, HostMigration->GetLocalPlayerKey(), EOnlineDataAdvertisementType::ViaOnlineServiceAndPing);
 
 		SessionInterface->CreateSession(0, SESSION_NAME, SessionSettings);
 	}
@@ -158,47 +516,192 @@ void UUdemyPlatformGameInstance::CreateSession()
 
 void UUdemyPlatformGameInstance::RefreshServerList()
 {
+	// Cached sessions show up right away, fresh results are merged in when the search completes
+	if (Menu != nullptr && ServerList.Num() > 0)
+	{
+		Menu->SetServerList(ServerList);
+	}
+
+	if (!IsSessionCacheFresh())
+	{
+		FindSessions();
+	}
+}
+
+bool UUdemyPlatformGameInstance::IsSessionCacheFresh() const
+{
+	return LastSessionSearchTime.IsSet() && FPlatformTime::Seconds() - LastSessionSearchTime.GetValue() < SessionCacheTimeToLive;
+}
+
+void UUdemyPlatformGameInstance::FindSessions()
+{
+	if (!SessionInterface.IsValid())
+		return;
+
+	// Callers asking while a search is running get its results too
+	if (bSessionSearchInFlight)
+		return;
+
 	SessionSearch = MakeShareable(new FOnlineSessionSearch());
 	if (SessionSearch.IsValid())
 	{
 		//SessionSearch->bIsLanQuery = true;
-		SessionSearch->MaxSearchResults = 100;
+		SessionSearch->MaxSearchResults = MaxSearchResults;
 		SessionSearch->QuerySettings.Set(SEARCH_PRESENCE, true, EOnlineComparisonOp::Equals);
 
-		SessionInterface->FindSessions(0, SessionSearch.ToSharedRef());
+		// A LAN search lasts its whole timeout, the migration searches again instead of waiting
+		if (bMigrating)
+			SessionSearch->TimeoutInSeconds = MigrationSearchTimeout;
+
+		// Set first, a subsystem may complete the search before FindSessions returns
+		bSessionSearchInFlight = true;
+		if (!SessionInterface->FindSessions(0, SessionSearch.ToSharedRef()))
+			bSessionSearchInFlight = false;
 	}
 }
 
 void UUdemyPlatformGameInstance::OnFindSessionComplete(bool Success)
 {
-	if (Success && SessionSearch.IsValid() && Menu != nullptr)
+	UDEMY_TICK_PROFILER_SCOPE(this, Sessions);
+
+	bSessionSearchInFlight = false;
+
+	if (!Success || !SessionSearch.IsValid())
+	{
+		if (bQuickMatching)
+			TryQuickMatchJoin();
+
+		if (bMigrating)
+			ContinueHostMigration();
+		return;
+	}
+
+	LastSessionSearchTime = FPlatformTime::Seconds();
+
+	MergeSearchResults(SessionSearch->SearchResults);
+
+	if (Menu != nullptr)
+	{
+		Menu->SetServerList(ServerList);
+	}
+
+	ProbeServerLatency();
+
+	if (bQuickMatching)
+		TryQuickMatchJoin();
+
+	if (bMigrating)
+		ContinueHostMigration();
+}
+
+void UUdemyPlatformGameInstance::MergeSearchResults(const TArray<FOnlineSessionSearchResult>& SearchResults)
+{
+	TSet<FString> FoundSessionIds;
+	FoundSessionIds.Reserve(SearchResults.Num());
+
+	for (const FOnlineSessionSearchResult& SearchResult : SearchResults)
 	{
-		// 서버 목록들을 넣어서 저장하는 리스트 변수
-		TArray<FServerData> ServerNames;
+		UE_LOG(LogTemp, Warning, TEXT("Found session names : %s"), *SearchResult.GetSessionIdStr());
+		FServerData Data;
+		Data.SessionId = SearchResult.GetSessionIdStr();
+		Data.PingInMs = SearchResult.PingInMs;
+		Data.MaxPlayers = SearchResult.Session.SessionSettings.NumPublicConnections;
+		Data.CurrentPlayers = Data.MaxPlayers - SearchResult.Session.NumOpenPublicConnections;
+		Data.HostUserName = SearchResult.Session.OwningUserName;
+
+		FString ServerName;
+		if (SearchResult.Session.SessionSettings.Get(SERVER_NAME_SETTINGS_KEY, ServerName))
+		{
+			Data.Name = ServerName;
+		}
+		else
+		{
+			Data.Name = "Could not find name.";
+		}
 
-		for (const FOnlineSessionSearchResult& SearchResult : SessionSearch->SearchResults)
+		FoundSessionIds.Add(Data.SessionId);
+
+		if (const int32* CachedIndex = ServerIndexBySessionId.Find(Data.SessionId))
 		{
-			UE_LOG(LogTemp, Warning, TEXT("Found session names : %s"), *SearchResult.GetSessionIdStr());
-			FServerData Data;
-			Data.MaxPlayers = SearchResult.Session.SessionSettings.NumPublicConnections;
-			Data.CurrentPlayers = Data.MaxPlayers - SearchResult.Session.NumOpenPublicConnections;
-			Data.HostUserName = SearchResult.Session.OwningUserName;
-
-			FString ServerName;
-			if (SearchResult.Session.SessionSettings.Get(SERVER_NAME_SETTINGS_KEY, ServerName))
-			{
-				Data.Name = ServerName;
-			}
-			else
-			{
-				Data.Name = "Could not find name.";
-			}
+			// Keep the measured latency until the new probe answers
+			Data.PingInMs = ServerList[*CachedIndex].PingInMs;
 
-			ServerNames.Add(Data);
+			CachedSearchResults[*CachedIndex] = SearchResult;
+			ServerList[*CachedIndex] = Data;
+		}
+		else
+		{
+			ServerIndexBySessionId.Add(Data.SessionId, ServerList.Num());
+			CachedSearchResults.Add(SearchResult);
+			ServerList.Add(Data);
 		}
+	}
+
+	// Sessions the backend no longer reports are gone, both arrays are compacted in one pass
+	int32 KeptCount = 0;
+	for (int32 i = 0; i < ServerList.Num(); ++i)
+	{
+		if (!FoundSessionIds.Contains(ServerList[i].SessionId))
+			continue;
+
+		if (KeptCount != i)
+		{
+			ServerList[KeptCount] = MoveTemp(ServerList[i]);
+			CachedSearchResults[KeptCount] = MoveTemp(CachedSearchResults[i]);
+		}
+
+		ServerList[KeptCount].SearchResultIndex = KeptCount;
+		++KeptCount;
+	}
+
+	ServerList.SetNum(KeptCount);
+	CachedSearchResults.SetNum(KeptCount);
+
+	ServerIndexBySessionId.Reset();
+	ServerIndexBySessionId.Reserve(KeptCount);
+	for (int32 i = 0; i < KeptCount; ++i)
+	{
+		ServerIndexBySessionId.Add(ServerList[i].SessionId, i);
+	}
+}
+
+void UUdemyPlatformGameInstance::ProbeServerLatency()
+{
+	if (!LatencyProbe.IsValid() || !SessionInterface.IsValid())
+		return;
+
+	TMap<FString, FString> HostAddresses;
 
-		Menu->SetServerList(ServerNames);
+	for (const FOnlineSessionSearchResult& SearchResult : CachedSearchResults)
+	{
+		FString ConnectString;
+		if (!SessionInterface->GetResolvedConnectString(SearchResult, NAME_GamePort, ConnectString))
+			continue;
+
+		// Only IP hosts can be probed, other platforms keep the ping reported by the search
+		FString HostAddress;
+		FString Port;
+		if (!ConnectString.Split(TEXT(":"), &HostAddress, &Port, ESearchCase::IgnoreCase, ESearchDir::FromEnd))
+			HostAddress = ConnectString;
+
+		if (HostAddress.Len() > 0 && FChar::IsDigit(HostAddress[0]))
+			HostAddresses.Add(SearchResult.GetSessionIdStr(), HostAddress);
 	}
+
+	LatencyProbe->Start(HostAddresses);
+}
+
+void UUdemyPlatformGameInstance::OnLatencyMeasured(const FString& SessionId, int32 PingInMs)
+{
+	const int32* Index = ServerIndexBySessionId.Find(SessionId);
+	if (Index == nullptr)
+		return;
+
+	FServerData& Data = ServerList[*Index];
+	Data.PingInMs = PingInMs;
+
+	if (Menu != nullptr)
+		Menu->UpdateServer(Data);
 }
 
 void UUdemyPlatformGameInstance::Join(uint32 Index)
@@ -206,7 +709,7 @@ void UUdemyPlatformGameInstance::Join(uint32 Index)
 	if (!SessionInterface.IsValid())
 		return;
 
-	if (!SessionSearch.IsValid())
+	if (!CachedSearchResults.IsValidIndex(Index))
 		return;
 
 	if (Menu != nullptr)
@@ -214,18 +717,41 @@ void UUdemyPlatformGameInstance::Join(uint32 Index)
 		Menu->Teardown();
 	}
 	
-	SessionInterface->JoinSession(0, SESSION_NAME, SessionSearch->SearchResults[Index]);
+	LastJoinedSession = CachedSearchResults[Index];
+
+	SessionInterface->JoinSession(0, SESSION_NAME, CachedSearchResults[Index]);
 }
 
 void UUdemyPlatformGameInstance::OnJoinSessionComplete(FName SessionName, EOnJoinSessionCompleteResult::Type Result)
 {
+	UDEMY_TICK_PROFILER_SCOPE(this, Sessions);
+
 	if (!SessionInterface.IsValid())
 		return;
 
+	if (Result != EOnJoinSessionCompleteResult::Success)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Could not join session : %s"), LexToString(Result));
+
+		// The failed session is already excluded, try the next best one
+		if (bQuickMatching)
+			RetryQuickMatch();
+
+		if (bReconnecting)
+			ScheduleReconnectAttempt();
+
+		if (bMigrating)
+			GetTimerManager().SetTimer(MigrationSearchTimer, this, &UUdemyPlatformGameInstance::FindSessions, MigrationSearchRetryDelay);
+		return;
+	}
+
 	FString Address;
 	if (!SessionInterface->GetResolvedConnectString(SessionName, Address))
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Could not get connect string."));
+
+		if (bQuickMatching)
+			RetryQuickMatch();
 		return;
 	}
 
@@ -236,8 +762,213 @@ void UUdemyPlatformGameInstance::OnJoinSessionComplete(FName SessionName, EOnJoi
 	APlayerController* PlayerController = GetFirstLocalPlayerController();
 
 	if (PlayerController != nullptr) {
+		// Until the map is loaded a travel or network failure sends the quick match on to the next candidate
+		bQuickMatchTraveling = bQuickMatching;
 		PlayerController->ClientTravel(Address, ETravelType::TRAVEL_Absolute);
 	}
+	else if (bQuickMatching)
+	{
+		RetryQuickMatch();
+	}
+}
+
+void UUdemyPlatformGameInstance::QuickMatch()
+{
+	if (!SessionInterface.IsValid() || bQuickMatching)
+		return;
+
+	bQuickMatching = true;
+	bQuickMatchTraveling = false;
+	bQuickMatchLeavingSession = false;
+	QuickMatchStartTime = FPlatformTime::Seconds();
+	QuickMatchFailedSessionIds.Reset();
+
+	GetTimerManager().SetTimer(QuickMatchDeadlineHandle, this, &UUdemyPlatformGameInstance::OnQuickMatchDeadline, QuickMatchDeadline);
+
+	// A fresh cache is good enough to pick from, otherwise the search completion picks
+	if (IsSessionCacheFresh())
+	{
+		TryQuickMatchJoin();
+	}
+	else
+	{
+		FindSessions();
+	}
+}
+
+bool UUdemyPlatformGameInstance::IsQuickMatchCandidate(int32 Index) const
+{
+	const FServerData& Data = ServerList[Index];
+
+	if (QuickMatchFailedSessionIds.Contains(Data.SessionId))
+		return false;
+
+	if (Data.MaxPlayers == 0 || Data.CurrentPlayers >= Data.MaxPlayers)
+		return false;
+
+	// Sessions of other builds would refuse the connection after the travel
+	int32 BuildVersion = 0;
+	if (!CachedSearchResults[Index].Session.SessionSettings.Get(BUILD_VERSION_SETTINGS_KEY, BuildVersion))
+		return false;
+
+	return (uint32)BuildVersion == FNetworkVersion::GetLocalNetworkVersion();
+}
+
+void UUdemyPlatformGameInstance::TryQuickMatchJoin()
+{
+	if (!bQuickMatching)
+		return;
+
+	int32 BestIndex = INDEX_NONE;
+	float BestScore = TNumericLimits<float>::Max();
+
+	for (int32 i = 0; i < ServerList.Num(); ++i)
+	{
+		if (!IsQuickMatchCandidate(i))
+			continue;
+
+		const float Score = FServerListModel::GetScore(ServerList[i]);
+		if (Score < BestScore)
+		{
+			BestScore = Score;
+			BestIndex = i;
+		}
+	}
+
+	if (BestIndex == INDEX_NONE)
+	{
+		// Nothing left to try once a search has answered, waiting for the deadline would only add latency
+		if (!bSessionSearchInFlight)
+			OnQuickMatchDeadline();
+		return;
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("Quick match joining %s (score %.0f)"), *ServerList[BestIndex].SessionId, BestScore);
+
+	// Marked up front so a failed join moves on to the next candidate
+	QuickMatchFailedSessionIds.Add(ServerList[BestIndex].SessionId);
+
+	GetTimerManager().ClearTimer(QuickMatchDeadlineHandle);
+
+	Join(BestIndex);
+}
+
+void UUdemyPlatformGameInstance::RetryQuickMatch()
+{
+	if (!bQuickMatching)
+		return;
+
+	bQuickMatchTraveling = false;
+
+	// The join left the candidate's session behind, OnDestroySessionComplete tries the next one
+	if (SessionInterface.IsValid() && SessionInterface->GetNamedSession(SESSION_NAME) != nullptr)
+	{
+		bQuickMatchLeavingSession = true;
+		SessionInterface->DestroySession(SESSION_NAME);
+		return;
+	}
+
+	TryQuickMatchJoin();
+}
+
+void UUdemyPlatformGameInstance::OnQuickMatchDeadline()
+{
+	if (!bQuickMatching)
+		return;
+
+	UE_LOG(LogTemp, Warning, TEXT("Quick match found no session, hosting"));
+
+	GetTimerManager().ClearTimer(QuickMatchDeadlineHandle);
+	bQuickMatching = false;
+	bQuickMatchTraveling = false;
+	bQuickMatchLeavingSession = false;
+
+	Host(FString::Printf(TEXT("%s's game"), FPlatformProcess::ComputerName()));
+}
+
+void UUdemyPlatformGameInstance::EndQuickMatch()
+{
+	GetTimerManager().ClearTimer(QuickMatchDeadlineHandle);
+	GetTimerManager().ClearTimer(QuickMatchRetryTimer);
+	bQuickMatching = false;
+	bQuickMatchTraveling = false;
+	bQuickMatchLeavingSession = false;
+	QuickMatchFailedSessionIds.Reset();
+}
+
+void UUdemyPlatformGameInstance::OnPostLoadMap(UWorld* World)
+{
+	// Remembered for the reconnect, whether the server was joined through a session or by address
+	if (World != nullptr && World->GetNetMode() == NM_Client)
+	{
+		LastConnectAddress = World->URL.Port != FURL::UrlConfig.DefaultPort
+			? FString::Printf(TEXT("%s:%d"), *World->URL.Host, World->URL.Port)
+			: World->URL.Host;
+
+		if (bReconnecting)
+		{
+			UE_LOG(LogTemp, Log, TEXT("Reconnected to %s in %.0f ms after %d attempt(s)"), *LastConnectAddress, (FPlatformTime::Seconds() - ReconnectStartTime) * 1000.0, ReconnectAttempts);
+			StopReconnect();
+
+			if (SimulatedOutageStart.IsSet())
+			{
+				UE_LOG(LogTemp, Log, TEXT("Back in game %.0f ms after the outage started"), (FPlatformTime::Seconds() - SimulatedOutageStart.GetValue()) * 1000.0);
+				SimulatedOutageStart.Reset();
+			}
+		}
+	}
+
+	if (bMigrating && World != nullptr)
+	{
+		if (World->GetNetMode() == NM_Standalone)
+		{
+			// Back on the default map after the disconnect, look for the old and the new host
+			FindSessions();
+		}
+		else
+		{
+			UE_LOG(LogTemp, Log, TEXT("Host migration: %s after %.0f ms"),
+				World->GetNetMode() == NM_ListenServer ? TEXT("hosting again") : TEXT("rejoined the new host"),
+				(FPlatformTime::Seconds() - MigrationStartTime) * 1000.0);
+			StopHostMigration();
+		}
+	}
+
+	// Menus opened by the new map's BeginPlay are already cached for it
+	ReleaseMenusOfOtherWorlds();
+
+	if (!bStartupReported && World != nullptr)
+	{
+		bStartupReported = true;
+
+		// Compare a dedicated server with a listen server by running both and reading this line
+		const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+		UE_LOG(LogTemp, Log, TEXT("Startup of %s (%s): %.2f s, %.1f MB used, %.1f MB peak"),
+			*World->GetMapName(),
+			IsRunningDedicatedServer() ? TEXT("dedicated server") : TEXT("game"),
+			FPlatformTime::Seconds() - GStartTime,
+			MemoryStats.UsedPhysical / (1024.0 * 1024.0),
+			MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0));
+	}
+
+	if (!QuickMatchStartTime.IsSet() || World == nullptr)
+		return;
+
+	// Back on the standalone menu after a failed travel, the retry is already scheduled
+	if (World->GetNetMode() == NM_Standalone)
+	{
+		if (bQuickMatching)
+			return;
+
+		UE_LOG(LogTemp, Warning, TEXT("Quick match failed after %.0f ms"), (FPlatformTime::Seconds() - QuickMatchStartTime.GetValue()) * 1000.0);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Log, TEXT("Quick match click to lobby: %.0f ms"), (FPlatformTime::Seconds() - QuickMatchStartTime.GetValue()) * 1000.0);
+	}
+
+	QuickMatchStartTime.Reset();
+	EndQuickMatch();
 }
 
 void UUdemyPlatformGameInstance::StartSession()
@@ -7,12 +7,13 @@
 #include "MenuSystem/MenuInterface.h"
 #include "OnlineSubsystem.h"
 #include "Interfaces/OnlineSessionInterface.h"
+#include "MenuSystem/ServerData.h"
 #include "UdemyPlatformGameInstance.generated.h"
 
 /**
  * 
  */
-UCLASS()
+UCLASS(Config = Game)
 class UDEMYPROJECT_API UUdemyPlatformGameInstance : public UGameInstance, public IMenuInterface
 {
 	GENERATED_BODY()
@@ -40,15 +41,137 @@ public:
 
 	void RefreshServerList() override;
 
+	UFUNCTION(Exec)
+	void QuickMatch() override;
+
+	/** Drops every packet to and from the server for Seconds, as if the network went down, to exercise the reconnect */
+	UFUNCTION(Exec)
+	void SimulateConnectionDrop(float Seconds = 10.0f);
+
+	/** Name the hosted session is advertised under */
+	const FString& GetServerName() const { return DesiredServerName; }
+
 private:
-	TSubclassOf<class UUserWidget> MenuClass;
-	TSubclassOf<class UUserWidget> InGameMenuClass;
+	TSoftClassPtr<class UUserWidget> MenuClass;
+	TSoftClassPtr<class UUserWidget> InGameMenuClass;
 
+	// Menus are created once per world and reused by every open
+	UPROPERTY()
 	class UMainMenu* Menu;
 
+	UPROPERTY()
+	class UMenuWidget* InGameMenu;
+
+	TWeakObjectPtr<UWorld> MenuWorld;
+
+	void ReleaseMenusOfOtherWorlds();
+
 	IOnlineSessionPtr SessionInterface;
 	TSharedPtr<class FOnlineSessionSearch> SessionSearch;
 
+	// Session cache: results of past searches merged by session id.
+	// ServerList[i] describes CachedSearchResults[i] and is updated in place as latency measurements arrive.
+	TArray<FOnlineSessionSearchResult> CachedSearchResults;
+	TArray<FServerData> ServerList;
+
+	// Index into both arrays by session id, a search can return thousands of sessions
+	TMap<FString, int32> ServerIndexBySessionId;
+
+	// Reopening the join menu within this many seconds of the last search reuses the cache without searching
+	float SessionCacheTimeToLive = 10.0f;
+
+	TOptional<double> LastSessionSearchTime;
+	bool bSessionSearchInFlight = false;
+
+	bool IsSessionCacheFresh() const;
+
+	/** Starts a session search unless one is already running */
+	void FindSessions();
+
+	void MergeSearchResults(const TArray<FOnlineSessionSearchResult>& SearchResults);
+
+	TSharedPtr<class FSessionLatencyProbe> LatencyProbe;
+
+	void ProbeServerLatency();
+	void OnLatencyMeasured(const FString& SessionId, int32 PingInMs);
+
+	// Quick match: sessions that failed to join or travel to are skipped, the deadline falls back to hosting
+	bool bQuickMatching = false;
+	bool bQuickMatchTraveling = false;
+	bool bQuickMatchLeavingSession = false;
+	TOptional<double> QuickMatchStartTime;
+	TSet<FString> QuickMatchFailedSessionIds;
+	FTimerHandle QuickMatchDeadlineHandle;
+	FTimerHandle QuickMatchRetryTimer;
+
+	// Seconds to find a joinable session before hosting instead
+	float QuickMatchDeadline = 3.0f;
+
+	// Seconds after a failed travel before the next candidate is tried, the engine tears the failed connection down first
+	float QuickMatchRetryDelay = 0.5f;
+
+	bool IsQuickMatchCandidate(int32 Index) const;
+	void TryQuickMatchJoin();
+	void RetryQuickMatch();
+	void OnQuickMatchDeadline();
+	void EndQuickMatch();
+
+	// Reconnect: after a dropped connection the client travels back to the last server with backoff,
+	// the server keeps its pawn for a grace window (AUdemyProjectGameMode)
+	FString LastConnectAddress;
+	TOptional<FOnlineSessionSearchResult> LastJoinedSession;
+
+	bool bReconnecting = false;
+	int32 ReconnectAttempts = 0;
+	double ReconnectStartTime = 0.0;
+	FTimerHandle ReconnectTimer;
+
+	float ReconnectInitialDelay = 0.25f;
+	float ReconnectMaxDelay = 4.0f;
+	int32 MaxReconnectAttempts = 8;
+
+	void StartReconnect();
+	void ScheduleReconnectAttempt();
+	void TryReconnect();
+	void StopReconnect();
+
+	void OnTravelFailure(UWorld* World, ETravelFailure::Type FailureType, const FString& ErrorString);
+
+	// Simulated outage: a reconnect attempt before it ends could not reach the server either
+	TOptional<double> SimulatedOutageStart;
+	double SimulatedOutageEnd = 0.0;
+	FTimerHandle SimulatedOutageTimer;
+
+	void SetSimulatedPacketLoss(int32 Percent);
+	void EndSimulatedOutage();
+
+	// Host migration: when a listen server host leaves, the player elected from its last snapshot
+	// (UHostMigrationSubsystem) hosts the same map under the same name and everyone else joins them
+	bool bMigrating = false;
+	bool bMigrationHosting = false;
+	double MigrationStartTime = 0.0;
+	FString OldHostKey;
+	FString ElectedHostKey;
+	FString MigrationMap;
+	FTimerHandle MigrationTimeoutTimer;
+	FTimerHandle MigrationSearchTimer;
+
+	// Players still not in a game after this many seconds go back to the menu
+	float MigrationTimeout = 20.0f;
+
+	// Short searches, the new host is looked for again until it shows up
+	float MigrationSearchTimeout = 1.0f;
+	float MigrationSearchRetryDelay = 0.5f;
+
+	void StartHostMigration();
+	void ContinueHostMigration();
+	void OnHostMigrationTimeout();
+	void StopHostMigration();
+	int32 FindCachedSessionOfHost(const FString& HostKey) const;
+
+	void OnPostLoadMap(UWorld* World);
+	bool bStartupReported = false;
+
 	void OnCreateSessionComplete(FName SessionName, bool Success);
 	void OnDestroySessionComplete(FName SessionName, bool Success);
 	void OnFindSessionComplete(bool Success);
@@ -56,5 +179,13 @@ private:
 	void OnNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString);
 
 	FString DesiredServerName;
+
+	// Sessions one search may return, the server list only creates rows for the visible ones
+	UPROPERTY(Config)
+	int32 MaxSearchResults = 10000;
+
+	// Public connections of hosted sessions, the replication graph keeps the cost per client flat up to 64
+	UPROPERTY(Config)
+	int32 MaxPlayers = 16;
 	void CreateSession();
 };
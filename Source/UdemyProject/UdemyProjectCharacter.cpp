@@ -4,22 +4,30 @@
 #include "Engine/LocalPlayer.h"
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
-#include "GameFramework/CharacterMovementComponent.h"
+#include "UdemyCharacterMovementComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "GameFramework/Controller.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputActionValue.h"
+#include "MovingPlatform.h"
+#include "OverlapRefreshSubsystem.h"
+#include "NetStatsSubsystem.h"
+#include "AssetPreloadSubsystem.h"
+#include "InputRecordingSubsystem.h"
 
 DEFINE_LOG_CATEGORY(LogTemplateCharacter);
 
 //////////////////////////////////////////////////////////////////////////
 // AUdemyProjectCharacter
 
-AUdemyProjectCharacter::AUdemyProjectCharacter()
+AUdemyProjectCharacter::AUdemyProjectCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UUdemyCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
-	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	// Overlaps near triggers are refreshed by UOverlapRefreshSubsystem, so the character itself never ticks
+	PrimaryActorTick.bCanEverTick = false;
+
+	UdemyMovementComponent = Cast<UUdemyCharacterMovementComponent>(GetCharacterMovement());
 
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
@@ -56,45 +64,38 @@ AUdemyProjectCharacter::AUdemyProjectCharacter()
 	// Note: The skeletal mesh and anim blueprint references on the Mesh component (inherited from Character) 
 	// are set in the derived blueprint asset named ThirdPersonCharacter (to avoid direct content references in C++)
 
-	static ConstructorHelpers::FObjectFinder<UInputAction> DashInput = TEXT("/Script/EnhancedInput.InputAction'/Game/ThirdPerson/Input/Actions/IA_Dash.IA_Dash'");
-	if (DashInput.Object) {
-		DashAction = DashInput.Object;
-	}
-
-	static ConstructorHelpers::FObjectFinder<UInputAction> DodgeInput = TEXT("/Script/EnhancedInput.InputAction'/Game/ThirdPerson/Input/Actions/IA_Dodge.IA_Dodge'");
-	if (DodgeInput.Object) {
-		DodgeAction = DodgeInput.Object;
-	}
-
-	const ConstructorHelpers::FObjectFinder<UCurveFloat> Curve(TEXT("/Script/Engine.CurveFloat'/Game/Udemy/Character/Dodge/CV_Dodge.CV_Dodge'"));
-	if (Curve.Succeeded()) {
-		DodgeCurve = Curve.Object;
-	}
-
-	DodgeTimeline = CreateDefaultSubobject<UTimelineComponent>(TEXT("DodgeTimeline"));
-	DodgeDistance = 500.0f;
-	DashDirection = FVector::ZeroVector;
-	DashVelocity = FVector::ZeroVector;
+	// Servers and simulated proxies never bind input, so the actions are not loaded with the class
+	DashAction = TSoftObjectPtr<UInputAction>(FSoftObjectPath(TEXT("/Game/ThirdPerson/Input/Actions/IA_Dash.IA_Dash")));
+	DodgeAction = TSoftObjectPtr<UInputAction>(FSoftObjectPath(TEXT("/Game/ThirdPerson/Input/Actions/IA_Dodge.IA_Dodge")));
 }
 
 void AUdemyProjectCharacter::BeginPlay()
 {
 	// Call the base class  
 	Super::BeginPlay();
+}
+
+void AUdemyProjectCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UOverlapRefreshSubsystem* OverlapRefresh = GetWorld()->GetSubsystem<UOverlapRefreshSubsystem>())
+	{
+		OverlapRefresh->RemoveCharacter(this);
+	}
 
-	FOnTimelineFloat DodgeCallback;
-	DodgeCallback.BindUFunction(this, FName("DodgeInterpReturn"));
-	DodgeTimeline->SetLooping(false);
-	DodgeTimeline->AddInterpFloat(DodgeCurve, DodgeCallback);
-	DodgeTimeline->SetTimelineLength(0.25f);
+	Super::EndPlay(EndPlayReason);
 }
 
-void AUdemyProjectCharacter::Tick(float DeltaTime)
+void AUdemyProjectCharacter::BaseChange()
 {
-	Super::Tick(DeltaTime);
+	Super::BaseChange();
+
+	UPrimitiveComponent* MovementBase = GetMovementBase();
+	const bool bOnMovingPlatform = MovementBase != nullptr && Cast<AMovingPlatform>(MovementBase->GetOwner()) != nullptr;
 
-	GetCharacterMovement()->MoveUpdatedComponent(FVector(1.0f, 1.0f, 0.0f), GetActorRotation(), true);
-	GetCharacterMovement()->MoveUpdatedComponent(FVector(-1.0f, -1.0f, 0.0f), GetActorRotation(), true);
+	if (UOverlapRefreshSubsystem* OverlapRefresh = GetWorld()->GetSubsystem<UOverlapRefreshSubsystem>())
+	{
+		OverlapRefresh->SetCharacterOnMovingPlatform(this, bOnMovingPlatform);
+	}
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -115,8 +116,8 @@ void AUdemyProjectCharacter::SetupPlayerInputComponent(UInputComponent* PlayerIn
 	if (UEnhancedInputComponent* EnhancedInputComponent = Cast<UEnhancedInputComponent>(PlayerInputComponent)) {
 		
 		// Jumping
-		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Started, this, &ACharacter::Jump);
-		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Completed, this, &ACharacter::StopJumping);
+		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Started, this, &AUdemyProjectCharacter::StartJump);
+		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Completed, this, &AUdemyProjectCharacter::StopJump);
 
 		// Moving
 		EnhancedInputComponent->BindAction(MoveAction, ETriggerEvent::Triggered, this, &AUdemyProjectCharacter::Move);
@@ -125,11 +126,12 @@ void AUdemyProjectCharacter::SetupPlayerInputComponent(UInputComponent* PlayerIn
 		EnhancedInputComponent->BindAction(LookAction, ETriggerEvent::Triggered, this, &AUdemyProjectCharacter::Look);
 
 		//Dashing
-		EnhancedInputComponent->BindAction(DashAction, ETriggerEvent::Started, this, &AUdemyProjectCharacter::StartDash);
-		EnhancedInputComponent->BindAction(DashAction, ETriggerEvent::Completed, this, &AUdemyProjectCharacter::StopDash);
+		UInputAction* LoadedDashAction = UAssetPreloadSubsystem::Load(this, DashAction);
+		EnhancedInputComponent->BindAction(LoadedDashAction, ETriggerEvent::Started, this, &AUdemyProjectCharacter::StartDash);
+		EnhancedInputComponent->BindAction(LoadedDashAction, ETriggerEvent::Completed, this, &AUdemyProjectCharacter::StopDash);
 
-		//Dodging
-		EnhancedInputComponent->BindAction(DodgeAction, ETriggerEvent::Triggered, this, &AUdemyProjectCharacter::DodgeCheck);
+		//Dodging, once per press; holding the key does not dodge again
+		EnhancedInputComponent->BindAction(UAssetPreloadSubsystem::Load(this, DodgeAction), ETriggerEvent::Started, this, &AUdemyProjectCharacter::DodgeCheck);
 	}
 	else
 	{
@@ -142,6 +144,9 @@ void AUdemyProjectCharacter::Move(const FInputActionValue& Value)
 	// input is a Vector2D
 	FVector2D MovementVector = Value.Get<FVector2D>();
 
+	if (UInputRecordingSubsystem* InputRecording = GetInputRecording())
+		InputRecording->RecordMove(MovementVector);
+
 	if (Controller != nullptr)
 	{
 		// find out which way is forward
@@ -162,12 +167,22 @@ void AUdemyProjectCharacter::Move(const FInputActionValue& Value)
 
 void AUdemyProjectCharacter::StartDash(const FInputActionValue& Value)
 {
-	GetCharacterMovement()->MaxWalkSpeed = 800.0f;
+	if (UInputRecordingSubsystem* InputRecording = GetInputRecording())
+		InputRecording->RecordButton(FRecordedInputFrame::DashStarted);
+
+	if (UdemyMovementComponent != nullptr) {
+		UdemyMovementComponent->SetSprinting(true);
+	}
 }
 
 void AUdemyProjectCharacter::StopDash(const FInputActionValue& Value)
 {
-	GetCharacterMovement()->MaxWalkSpeed = 500.0f;
+	if (UInputRecordingSubsystem* InputRecording = GetInputRecording())
+		InputRecording->RecordButton(FRecordedInputFrame::DashStopped);
+
+	if (UdemyMovementComponent != nullptr) {
+		UdemyMovementComponent->SetSprinting(false);
+	}
 }
 
 void AUdemyProjectCharacter::Look(const FInputActionValue& Value)
@@ -175,6 +190,9 @@ void AUdemyProjectCharacter::Look(const FInputActionValue& Value)
 	// input is a Vector2D
 	FVector2D LookAxisVector = Value.Get<FVector2D>();
 
+	if (UInputRecordingSubsystem* InputRecording = GetInputRecording())
+		InputRecording->RecordLook(LookAxisVector);
+
 	if (Controller != nullptr)
 	{
 		// add yaw and pitch input to controller
@@ -185,30 +203,80 @@ void AUdemyProjectCharacter::Look(const FInputActionValue& Value)
 
 void AUdemyProjectCharacter::DodgeCheck(const FInputActionValue& Value)
 {
-	// If input vector not equal ZeroVector
-	if (GetCharacterMovement()->GetLastInputVector() != FVector::ZeroVector) {
-		FHitResult HitResult;
-
-		bool IsHit = GetWorld()->LineTraceSingleByChannel(HitResult,
-			GetActorLocation(),
-			GetActorLocation() + (GetCharacterMovement()->GetLastInputVector() * DodgeDistance),
-			ECollisionChannel::ECC_Visibility);
+	if (UInputRecordingSubsystem* InputRecording = GetInputRecording())
+		InputRecording->RecordButton(FRecordedInputFrame::Dodge);
 
-		if (IsHit)
-			Dodge(HitResult.Location + (GetCharacterMovement()->GetLastInputVector() * -55.0f), GetActorForwardVector());
-		else
-			Dodge(GetActorLocation() + (GetCharacterMovement()->GetLastInputVector() * DodgeDistance), GetActorForwardVector());
+	// The movement component starts the dodge inside the predicted move, so the server replays it
+	if (UdemyMovementComponent != nullptr) {
+		UdemyMovementComponent->RequestDodge();
 	}
 }
 
-void AUdemyProjectCharacter::Dodge(const FVector DashDir, const FVector DashVel)
+void AUdemyProjectCharacter::StartJump(const FInputActionValue& Value)
 {
-	DashDirection = DashDir;
-	DashVelocity = DashVel;
-	DodgeTimeline->PlayFromStart();
+	if (UInputRecordingSubsystem* InputRecording = GetInputRecording())
+		InputRecording->RecordButton(FRecordedInputFrame::JumpStarted);
+
+	Jump();
+}
+
+void AUdemyProjectCharacter::StopJump(const FInputActionValue& Value)
+{
+	if (UInputRecordingSubsystem* InputRecording = GetInputRecording())
+		InputRecording->RecordButton(FRecordedInputFrame::JumpStopped);
+
+	StopJumping();
+}
+
+UInputRecordingSubsystem* AUdemyProjectCharacter::GetInputRecording() const
+{
+	UWorld* World = GetWorld();
+	return World != nullptr ? World->GetSubsystem<UInputRecordingSubsystem>() : nullptr;
+}
+
+void AUdemyProjectCharacter::ReplayInput(const FRecordedInputFrame& Frame)
+{
+	if (!Frame.Look.IsZero())
+		Look(FInputActionValue(FVector2D(Frame.Look)));
+	if (!Frame.Move.IsZero())
+		Move(FInputActionValue(FVector2D(Frame.Move)));
+
+	if (Frame.Buttons & FRecordedInputFrame::DashStarted)
+		StartDash(FInputActionValue());
+	if (Frame.Buttons & FRecordedInputFrame::JumpStarted)
+		StartJump(FInputActionValue());
+	if (Frame.Buttons & FRecordedInputFrame::Dodge)
+		DodgeCheck(FInputActionValue());
+
+	// A key tapped within one frame was pressed, then released
+	if (Frame.Buttons & FRecordedInputFrame::JumpStopped)
+		StopJump(FInputActionValue());
+	if (Frame.Buttons & FRecordedInputFrame::DashStopped)
+		StopDash(FInputActionValue());
 }
 
-void AUdemyProjectCharacter::DodgeInterpReturn(float value)
+void AUdemyProjectCharacter::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
 {
-	SetActorLocation(FMath::Lerp(GetActorLocation(), DashDirection, value));
-}
\ No newline at end of file
+	Super::PreReplication(ChangedPropertyTracker);
+
+	if (UNetStatsSubsystem* NetStats = GetWorld()->GetSubsystem<UNetStatsSubsystem>())
+		NetStats->RecordReplication(this);
+}
+
+void AUdemyProjectCharacter::PostNetReceive()
+{
+	Super::PostNetReceive();
+
+	// Once per received bunch of properties, replicated movement included
+	if (UNetStatsSubsystem* NetStats = GetWorld()->GetSubsystem<UNetStatsSubsystem>())
+		NetStats->RecordPropertyUpdate(this);
+}
+
+bool AUdemyProjectCharacter::CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack)
+{
+	// Movement RPCs of the character movement component go through here too
+	if (UNetStatsSubsystem* NetStats = GetWorld()->GetSubsystem<UNetStatsSubsystem>())
+		NetStats->RecordRpc(this);
+
+	return Super::CallRemoteFunction(Function, Parameters, OutParms, Stack);
+}
@@ -5,13 +5,13 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "Logging/LogMacros.h"
-#include "Components/TimelineComponent.h"
 #include "UdemyProjectCharacter.generated.h"
 
 class USpringArmComponent;
 class UCameraComponent;
 class UInputMappingContext;
 class UInputAction;
+class UUdemyCharacterMovementComponent;
 struct FInputActionValue;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogTemplateCharacter, Log, All);
@@ -45,16 +45,16 @@ class AUdemyProjectCharacter : public ACharacter
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (AllowPrivateAccess = "true"))
 	UInputAction* LookAction;
 
-	/** Dodge Input Action */
+	/** Dash Input Action, loaded when a local player takes control */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (AllowPrivateAccess = "true"))
-	class UInputAction* DashAction;
+	TSoftObjectPtr<UInputAction> DashAction;
 
-	/** Dash Input Action */
+	/** Dodge Input Action, loaded when a local player takes control */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (AllowPrivateAccess = "true"))
-	class UInputAction* DodgeAction;
+	TSoftObjectPtr<UInputAction> DodgeAction;
 
 public:
-	AUdemyProjectCharacter();
+	AUdemyProjectCharacter(const FObjectInitializer& ObjectInitializer);
 	
 
 protected:
@@ -71,11 +71,15 @@ protected:
 	/** Called for dash input */
 	void StopDash(const FInputActionValue& Value);
 
-	/** Called for dodging input */
+	/** Called when the dodge key is pressed */
 	void DodgeCheck(const FInputActionValue& Value);
 
-	//UFUNCTION(BlueprintImplementableEvent)
-	void Dodge(const FVector DashDir, const FVector DashVel);
+	/** Called for jump input */
+	void StartJump(const FInputActionValue& Value);
+	void StopJump(const FInputActionValue& Value);
+
+	/** The input recorder of this world while the game runs with -RecordInput */
+	class UInputRecordingSubsystem* GetInputRecording() const;
 			
 
 protected:
@@ -85,29 +89,29 @@ protected:
 	// To add mapping context
 	virtual void BeginPlay();
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
+	// Keeps overlap refresh registered only while standing on a moving platform
+	virtual void BaseChange() override;
+
+	/** Feeds one frame of input through the same handlers as the bound input actions, for the input replay and bot clients */
+	void ReplayInput(const struct FRecordedInputFrame& Frame);
+
+	// Counted by UNetStatsSubsystem
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+	virtual void PostNetReceive() override;
+	virtual bool CallRemoteFunction(UFunction* Function, void* Parameters, struct FOutParmRec* OutParms, FFrame* Stack) override;
 
 	/** Returns CameraBoom subobject **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	/** Returns FollowCamera subobject **/
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
+	/** Returns UdemyMovementComponent subobject **/
+	FORCEINLINE UUdemyCharacterMovementComponent* GetUdemyMovementComponent() const { return UdemyMovementComponent; }
 
 private:
-	UPROPERTY(EditAnywhere, Category = "Dodge Option", meta = (AllowPrivateAccess = "true"))
-	float DodgeDistance;
-
 	UPROPERTY()
-	UTimelineComponent* DodgeTimeline;
-
-	UPROPERTY()
-	UCurveFloat* DodgeCurve;
-
-	UFUNCTION()
-	void DodgeInterpReturn(float value);
-
-	FVector DashDirection;
-	FVector DashVelocity;
+	UUdemyCharacterMovementComponent* UdemyMovementComponent;
 };
 
@@ -2,14 +2,139 @@
 
 #include "UdemyProjectGameMode.h"
 #include "UdemyProjectCharacter.h"
-#include "UObject/ConstructorHelpers.h"
+#include "UdemyProjectGameState.h"
+#include "UdemyProjectPlayerController.h"
+#include "AssetPreloadSubsystem.h"
+#include "HostMigrationSubsystem.h"
+#include "Engine/GameInstance.h"
+#include "GameFramework/GameSession.h"
+#include "GameFramework/PawnMovementComponent.h"
+#include "GameFramework/PlayerState.h"
+#include "TimerManager.h"
 
 AUdemyProjectGameMode::AUdemyProjectGameMode()
 {
 	// set default pawn class to our Blueprinted character
-	static ConstructorHelpers::FClassFinder<APawn> PlayerPawnBPClass(TEXT("/Game/ThirdPerson/Blueprints/BP_ThirdPersonCharacter"));
-	if (PlayerPawnBPClass.Class != NULL)
+	DefaultPawnSoftClass = TSoftClassPtr<APawn>(FSoftObjectPath(TEXT("/Game/ThirdPerson/Blueprints/BP_ThirdPersonCharacter.BP_ThirdPersonCharacter_C")));
+
+	PlayerControllerClass = AUdemyProjectPlayerController::StaticClass();
+	GameStateClass = AUdemyProjectGameState::StaticClass();
+}
+
+void AUdemyProjectGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	if (!DefaultPawnSoftClass.IsNull())
+	{
+		TSubclassOf<APawn> PawnClass = UAssetPreloadSubsystem::Load(this, DefaultPawnSoftClass);
+		if (PawnClass != nullptr)
+			DefaultPawnClass = PawnClass;
+	}
+}
+
+void AUdemyProjectGameMode::StartPlay()
+{
+	Super::StartPlay();
+
+	// Platforms registered with the simulation in their BeginPlay
+	UHostMigrationSubsystem* HostMigration = UGameInstance::GetSubsystem<UHostMigrationSubsystem>(GetGameInstance());
+	if (HostMigration != nullptr)
+		HostMigration->RestorePlatforms(GetWorld());
+}
+
+void AUdemyProjectGameMode::PreLogin(const FString& Options, const FString& Address, const FUniqueNetIdRepl& UniqueId, FString& ErrorMessage)
+{
+	Super::PreLogin(Options, Address, UniqueId, ErrorMessage);
+
+	if (!ErrorMessage.IsEmpty() || GameSession == nullptr)
+		return;
+
+	// Reserved slots count as taken for everyone but their owner
+	if (!ReservedSlots.Contains(GetPlayerKey(UniqueId)) && GetNumPlayers() + ReservedSlots.Num() >= GameSession->MaxPlayers)
+		ErrorMessage = TEXT("Server full.");
+}
+
+void AUdemyProjectGameMode::RestartPlayer(AController* NewPlayer)
+{
+	const APlayerState* PlayerState = NewPlayer != nullptr ? NewPlayer->PlayerState.Get() : nullptr;
+	const FString Key = PlayerState != nullptr ? GetPlayerKey(PlayerState->GetUniqueId()) : FString();
+
+	FReservedSlot Slot;
+	if (!Key.IsEmpty() && ReservedSlots.RemoveAndCopyValue(Key, Slot) && Slot.Pawn.IsValid() && NewPlayer->GetPawn() == nullptr)
+	{
+		APawn* Pawn = Slot.Pawn.Get();
+		NewPlayer->Possess(Pawn);
+		NewPlayer->ClientSetRotation(Pawn->GetActorRotation(), true);
+
+		UE_LOG(LogTemp, Log, TEXT("%s reclaimed their pawn"), *PlayerState->GetPlayerName());
+		return;
+	}
+
+	Super::RestartPlayer(NewPlayer);
+
+	UHostMigrationSubsystem* HostMigration = UGameInstance::GetSubsystem<UHostMigrationSubsystem>(GetGameInstance());
+
+	FPlayerSnapshot Snapshot;
+	if (HostMigration != nullptr && HostMigration->TakeRestoredPlayer(Key, Snapshot))
+		RestoreMigratedPlayer(NewPlayer, Snapshot);
+}
+
+void AUdemyProjectGameMode::RestoreMigratedPlayer(AController* Player, const FPlayerSnapshot& Snapshot)
+{
+	APawn* Pawn = Player->GetPawn();
+	if (Pawn == nullptr)
+		return;
+
+	const FRotator Rotation(0.0f, Snapshot.Yaw, 0.0f);
+	Pawn->TeleportTo(Snapshot.Location, Rotation);
+	Player->ClientSetRotation(Rotation, true);
+}
+
+bool AUdemyProjectGameMode::ReserveSlot(APlayerController* LeavingPlayer, APawn* Pawn)
+{
+	if (LeavingPlayer == nullptr || LeavingPlayer->PlayerState == nullptr || Pawn == nullptr)
+		return false;
+
+	const FString Key = GetPlayerKey(LeavingPlayer->PlayerState->GetUniqueId());
+	if (Key.IsEmpty())
+		return false;
+
+	FReservedSlot& Slot = ReservedSlots.Add(Key);
+	Slot.Pawn = Pawn;
+	Slot.ExpireTime = GetWorld()->GetTimeSeconds() + ReconnectGraceSeconds;
+
+	// The pawn stays where it was, without input, until its owner returns
+	if (Pawn->GetMovementComponent() != nullptr)
+		Pawn->GetMovementComponent()->StopMovementImmediately();
+
+	if (!GetWorldTimerManager().IsTimerActive(ExpireReservedSlotsTimer))
+		GetWorldTimerManager().SetTimer(ExpireReservedSlotsTimer, this, &AUdemyProjectGameMode::ExpireReservedSlots, 1.0f, true);
+
+	UE_LOG(LogTemp, Log, TEXT("Holding the slot of %s for %.0f s"), *LeavingPlayer->PlayerState->GetPlayerName(), ReconnectGraceSeconds);
+	return true;
+}
+
+FString AUdemyProjectGameMode::GetPlayerKey(const FUniqueNetIdRepl& UniqueId)
+{
+	return UniqueId.IsValid() ? UniqueId->ToString() : FString();
+}
+
+void AUdemyProjectGameMode::ExpireReservedSlots()
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	for (auto It = ReservedSlots.CreateIterator(); It; ++It)
 	{
-		DefaultPawnClass = PlayerPawnBPClass.Class;
+		if (It.Value().Pawn.IsValid() && It.Value().ExpireTime > Now)
+			continue;
+
+		if (APawn* Pawn = It.Value().Pawn.Get())
+			Pawn->Destroy();
+
+		It.RemoveCurrent();
 	}
+
+	if (ReservedSlots.Num() == 0)
+		GetWorldTimerManager().ClearTimer(ExpireReservedSlotsTimer);
 }
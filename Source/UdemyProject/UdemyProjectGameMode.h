@@ -6,6 +6,8 @@
 #include "GameFramework/GameModeBase.h"
 #include "UdemyProjectGameMode.generated.h"
 
+struct FPlayerSnapshot;
+
 UCLASS(minimalapi)
 class AUdemyProjectGameMode : public AGameModeBase
 {
@@ -13,6 +15,51 @@ class AUdemyProjectGameMode : public AGameModeBase
 
 public:
 	AUdemyProjectGameMode();
+
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+	/** On a migrated host, puts the platforms back where the old host left them */
+	virtual void StartPlay() override;
+
+	virtual void PreLogin(const FString& Options, const FString& Address, const FUniqueNetIdRepl& UniqueId, FString& ErrorMessage) override;
+
+	/** Gives a returning player back the pawn they left behind, or their place before a host migration */
+	virtual void RestartPlayer(AController* NewPlayer) override;
+
+	/**
+	 * Keeps the slot and pawn of a player who left for ReconnectGraceSeconds.
+	 * Returns false if the player cannot be identified, the pawn is then destroyed as usual.
+	 */
+	bool ReserveSlot(APlayerController* LeavingPlayer, APawn* Pawn);
+
+	static FString GetPlayerKey(const FUniqueNetIdRepl& UniqueId);
+
+	const TSoftClassPtr<APawn>& GetDefaultPawnSoftClass() const { return DefaultPawnSoftClass; }
+
+protected:
+	/** Applies what the old host's snapshot recorded about a player who rejoined the migrated host */
+	virtual void RestoreMigratedPlayer(AController* Player, const FPlayerSnapshot& Snapshot);
+
+	/** Loaded into DefaultPawnClass when the game starts instead of when the class default object is built */
+	UPROPERTY(EditDefaultsOnly, Category = Classes)
+	TSoftClassPtr<APawn> DefaultPawnSoftClass;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Reconnect")
+	float ReconnectGraceSeconds = 30.0f;
+
+private:
+	struct FReservedSlot
+	{
+		TWeakObjectPtr<APawn> Pawn;
+		double ExpireTime = 0.0;
+	};
+
+	void ExpireReservedSlots();
+
+	// Keyed by unique net id
+	TMap<FString, FReservedSlot> ReservedSlots;
+
+	FTimerHandle ExpireReservedSlotsTimer;
 };
 
 
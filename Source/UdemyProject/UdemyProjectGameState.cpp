@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UdemyProjectGameState.h"
+
+#include "Engine/GameInstance.h"
+#include "Net/UnrealNetwork.h"
+
+#include "NetStatsSubsystem.h"
+
+void AUdemyProjectGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AUdemyProjectGameState, MigrationSnapshot);
+}
+
+void AUdemyProjectGameState::PostNetReceive()
+{
+	Super::PostNetReceive();
+
+	if (UNetStatsSubsystem* NetStats = GetWorld()->GetSubsystem<UNetStatsSubsystem>())
+		NetStats->RecordPropertyUpdate(this);
+}
+
+void AUdemyProjectGameState::SetMigrationSnapshot(const FHostMigrationSnapshot& Snapshot)
+{
+	MigrationSnapshot = Snapshot;
+}
+
+void AUdemyProjectGameState::OnRep_MigrationSnapshot()
+{
+	UHostMigrationSubsystem* HostMigration = UGameInstance::GetSubsystem<UHostMigrationSubsystem>(GetGameInstance());
+	if (HostMigration != nullptr)
+		HostMigration->ReceiveSnapshot(MigrationSnapshot);
+}
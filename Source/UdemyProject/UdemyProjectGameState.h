@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameStateBase.h"
+#include "HostMigrationSubsystem.h"
+#include "UdemyProjectGameState.generated.h"
+
+/**
+ * Carries the host migration snapshot of a listen server to its clients,
+ * so any of them can take over with the same players and platforms if the host leaves.
+ */
+UCLASS()
+class UDEMYPROJECT_API AUdemyProjectGameState : public AGameStateBase
+{
+	GENERATED_BODY()
+
+public:
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// Counted by UNetStatsSubsystem, for ALobbyGameState too
+	virtual void PostNetReceive() override;
+
+	/** Server only */
+	void SetMigrationSnapshot(const FHostMigrationSnapshot& Snapshot);
+
+private:
+	UPROPERTY(ReplicatedUsing = OnRep_MigrationSnapshot)
+	FHostMigrationSnapshot MigrationSnapshot;
+
+	UFUNCTION()
+	void OnRep_MigrationSnapshot();
+};
@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UdemyProjectPlayerController.h"
+
+#include "UdemyProjectGameMode.h"
+
+void AUdemyProjectPlayerController::PawnLeavingGame()
+{
+	AUdemyProjectGameMode* GameMode = GetWorld()->GetAuthGameMode<AUdemyProjectGameMode>();
+	APawn* LeavingPawn = GetPawn();
+
+	if (GameMode != nullptr && LeavingPawn != nullptr && GameMode->ReserveSlot(this, LeavingPawn))
+	{
+		UnPossess();
+		return;
+	}
+
+	Super::PawnLeavingGame();
+}
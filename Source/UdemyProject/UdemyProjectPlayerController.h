@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerController.h"
+#include "UdemyProjectPlayerController.generated.h"
+
+/**
+ * Gameplay player controller. A player who drops keeps their pawn in the world while the game mode
+ * holds their slot, instead of the pawn being destroyed with the controller.
+ */
+UCLASS()
+class UDEMYPROJECT_API AUdemyProjectPlayerController : public APlayerController
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void PawnLeavingGame() override;
+};
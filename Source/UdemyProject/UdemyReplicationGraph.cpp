@@ -0,0 +1,176 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UdemyReplicationGraph.h"
+
+#include "GameFramework/Character.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "ReplicationGraphTypes.h"
+#include "UObject/UObjectIterator.h"
+
+#include "MovingPlatform.h"
+#include "TickProfilerSubsystem.h"
+
+void UUdemyReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	ClassRepNodePolicies.Set(APlayerController::StaticClass(), EClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(APlayerState::StaticClass(), EClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(AGameStateBase::StaticClass(), EClassRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(ACharacter::StaticClass(), EClassRepNodeMapping::Spatialize_Dynamic);
+
+	// Platforms only send their path once and their phase when a trigger flips it.
+	// Level actors that drop out of relevancy would be destroyed on clients, so they stay relevant.
+	ClassRepNodePolicies.Set(AMovingPlatform::StaticClass(), EClassRepNodeMapping::RelevantAllConnections);
+
+	// Farther characters are skipped first when a connection runs out of bandwidth
+	FClassReplicationInfo CharacterInfo;
+	CharacterInfo.DistancePriorityScale = 1.0f;
+	CharacterInfo.StarvationPriorityScale = 1.0f;
+	CharacterInfo.ActorChannelFrameTimeout = 4;
+	CharacterInfo.SetCullDistanceSquared(CharacterCullDistance * CharacterCullDistance);
+	CharacterInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(GetDefault<ACharacter>()->NetUpdateFrequency);
+	GlobalActorReplicationInfoMap.SetClassInfo(ACharacter::StaticClass(), CharacterInfo);
+
+	FClassReplicationInfo PlatformInfo;
+	PlatformInfo.DistancePriorityScale = 0.0f;
+	PlatformInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(GetDefault<AMovingPlatform>()->NetUpdateFrequency);
+	GlobalActorReplicationInfoMap.SetClassInfo(AMovingPlatform::StaticClass(), PlatformInfo);
+
+	// Every other replicated class loaded by now gets the cull distance and rate of its defaults,
+	// classes loaded later get theirs when their first actor is added
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		if (Class->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated | CLASS_NewerVersionExists))
+			continue;
+
+		// Blueprint compilation leftovers
+		if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+			continue;
+
+		const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject(false));
+		if (ActorCDO == nullptr || !ActorCDO->GetIsReplicated())
+			continue;
+
+		InitClassReplicationInfo(Class);
+	}
+}
+
+bool UUdemyReplicationGraph::InitClassReplicationInfo(UClass* Class)
+{
+	// Subclasses of the classes set up above inherit their settings through the class map
+	if (Class->IsChildOf(ACharacter::StaticClass()) || Class->IsChildOf(AMovingPlatform::StaticClass()))
+		return false;
+
+	if (ClassesWithReplicationInfo.Contains(Class))
+		return false;
+
+	ClassesWithReplicationInfo.Add(Class);
+
+	const AActor* ActorCDO = Class->GetDefaultObject<AActor>();
+	const EClassRepNodeMapping Policy = GetMappingPolicy(Class);
+
+	// Without a cull distance the grid would send the actor to connections at any distance, and every frame without a period
+	FClassReplicationInfo ClassInfo;
+	if (Policy == EClassRepNodeMapping::Spatialize_Static || Policy == EClassRepNodeMapping::Spatialize_Dynamic)
+		ClassInfo.SetCullDistanceSquared(ActorCDO->NetCullDistanceSquared);
+	ClassInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(ActorCDO->NetUpdateFrequency);
+	GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+
+	return true;
+}
+
+void UUdemyReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = SpatialBias;
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+
+	PlayerStateNode = CreateNewNode<UReplicationGraphNode_PlayerStateFrequencyLimiter>();
+	AddGlobalGraphNode(PlayerStateNode);
+}
+
+void UUdemyReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	// The connection's own controller, pawn and view target
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantForConnectionNode = CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(AlwaysRelevantForConnectionNode, RepGraphConnection);
+}
+
+void UUdemyReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	// Blueprint classes loaded after startup, e.g. the game map's content after the travel from the lobby.
+	// This actor's settings were already copied from the default class info, so they are replaced too.
+	if (InitClassReplicationInfo(ActorInfo.Class))
+		GlobalInfo.Settings = GlobalActorReplicationInfoMap.GetClassInfo(ActorInfo.Class);
+
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+	case EClassRepNodeMapping::Spatialize_Static:
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+		break;
+	case EClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+	default:
+		break;
+	}
+}
+
+void UUdemyReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+	case EClassRepNodeMapping::Spatialize_Static:
+		GridNode->RemoveActor_Static(ActorInfo);
+		break;
+	case EClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+	default:
+		break;
+	}
+}
+
+EClassRepNodeMapping UUdemyReplicationGraph::GetMappingPolicy(UClass* Class)
+{
+	if (const EClassRepNodeMapping* Policy = ClassRepNodePolicies.Get(Class))
+		return *Policy;
+
+	// Classes without an explicit policy are routed from their defaults, then cached
+	const AActor* ActorCDO = Class->GetDefaultObject<AActor>();
+
+	EClassRepNodeMapping Policy = EClassRepNodeMapping::Spatialize_Static;
+	if (ActorCDO->bAlwaysRelevant)
+		Policy = EClassRepNodeMapping::RelevantAllConnections;
+	else if (ActorCDO->bOnlyRelevantToOwner)
+		Policy = EClassRepNodeMapping::NotRouted;
+	else if (ActorCDO->IsReplicatingMovement() || Class->IsChildOf(APawn::StaticClass()))
+		Policy = EClassRepNodeMapping::Spatialize_Dynamic;
+
+	ClassRepNodePolicies.Set(Class, Policy);
+	return Policy;
+}
+
+int32 UUdemyReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+	UDEMY_TICK_PROFILER_SCOPE(this, Replication);
+
+	return Super::ServerReplicateActors(DeltaSeconds);
+}
@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "UdemyReplicationGraph.generated.h"
+
+enum class EClassRepNodeMapping : uint8
+{
+	// Handled by a dedicated node: player controllers per connection, player states by the frequency limiter
+	NotRouted,
+	RelevantAllConnections,
+
+	// Placed in the spatial grid once
+	Spatialize_Static,
+	// Moved in the spatial grid every frame
+	Spatialize_Dynamic,
+};
+
+/**
+ * Replaces the per-actor relevancy checks of the net driver with a spatial grid,
+ * so the cost per connection depends on what is near the player instead of on how many players there are.
+ * Characters are culled by distance and lose priority with it, platforms and the game state stay relevant to everyone,
+ * and player states are sent a few per frame.
+ * Enabled through ReplicationDriverClassName in DefaultEngine.ini.
+ */
+UCLASS(Transient, Config = Engine)
+class UDEMYPROJECT_API UUdemyReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+
+private:
+	EClassRepNodeMapping GetMappingPolicy(UClass* Class);
+
+	/** Sets the class info of a class without its own from its defaults. False if it already has one. */
+	bool InitClassReplicationInfo(UClass* Class);
+
+	// Classes InitClassReplicationInfo has seen
+	TSet<FObjectKey> ClassesWithReplicationInfo;
+
+	UPROPERTY(Config)
+	float GridCellSize = 10000.0f;
+
+	// Lowest corner of the playable area, the grid starts here
+	UPROPERTY(Config)
+	FVector2D SpatialBias = FVector2D(-200000.0f, -200000.0f);
+
+	UPROPERTY(Config)
+	float CharacterCullDistance = 15000.0f;
+
+	UPROPERTY()
+	class UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+	UPROPERTY()
+	class UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+	UPROPERTY()
+	class UReplicationGraphNode_PlayerStateFrequencyLimiter* PlayerStateNode;
+
+	TClassMap<EClassRepNodeMapping> ClassRepNodePolicies;
+};